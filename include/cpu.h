@@ -77,6 +77,7 @@ Bits CPU_Core_Dyn_X86_Run(void);
 Bits CPU_Core_Dyn_X86_Trap_Run(void);
 Bits CPU_Core_Dynrec_Run(void);
 Bits CPU_Core_Dynrec_Trap_Run(void);
+void CPU_Core_Dynrec_GetFlagsStats(Bitu & queued,Bitu & eliminated);
 Bits CPU_Core_Prefetch_Run(void);
 Bits CPU_Core_Prefetch_Trap_Run(void);
 
@@ -183,6 +184,8 @@ void CPU_SetFlags(Bitu word,Bitu mask);
 #define CR0_FPUPRESENT			0x00000010
 #define CR0_PAGING				0x80000000
 
+#define CR4_PAGEGLOBAL			0x00000080
+
 
 // *********************************************************************
 // Descriptor
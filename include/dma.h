@@ -78,6 +78,7 @@ public:
 	}
 	Bitu Read(Bitu size, Bit8u * buffer);
 	Bitu Write(Bitu size, Bit8u * buffer);
+	Bitu ReadDirect(Bitu size, Bit8u * & data, Bitu granule = 1);
 };
 
 class DmaController {
@@ -40,6 +40,13 @@ void OPL_ShutDown(Section* sec);
 void CMS_ShutDown(Section* sec);
 
 bool SB_Get_Address(Bitu& sbaddr, Bitu& sbirq, Bitu& sbdma);
+struct SB_DMA_Stats {
+	Bit64u calls;		//Blocks played by the DMA transfer handler
+	Bit64u bytes;		//Bytes read from guest memory
+	Bit64u direct;		//Bytes of those handed to the mixer without a copy
+	Bit64u underruns;	//Gaps of silence after a single cycle transfer ended
+};
+bool SB_Get_DMA_Stats(SB_DMA_Stats& stats);
 bool TS_Get_Address(Bitu& tsaddr, Bitu& tsirq, Bitu& tsdma);
 
 extern Bit8u adlib_commandreg;
@@ -112,6 +112,15 @@ void MEM_BlockRead(PhysPt pt,void * data,Bitu size);
 void MEM_BlockCopy(PhysPt dest,PhysPt src,Bitu size);
 void MEM_StrCopy(PhysPt pt,char * data,Bitu size);
 
+/* Host pointer to a block that maps to contiguous host memory, nullptr otherwise */
+HostPt MEM_GetBlockReadPt(PhysPt pt,Bitu size);
+HostPt MEM_GetBlockWritePt(PhysPt pt,Bitu size);
+
+/* Forward (DF=0) string moves and stores of count elements of size bytes at base+index,
+   the index wraps at mask and is updated. Plain memory is done on the host a page at a time */
+void MEM_StringMove(PhysPt si_base,Bitu & si_index,PhysPt di_base,Bitu & di_index,Bitu mask,Bitu count,Bitu size);
+void MEM_StringStore(PhysPt di_base,Bitu & di_index,Bitu mask,Bitu count,Bitu size,Bit32u val);
+
 void mem_memcpy(PhysPt dest,PhysPt src,Bitu size);
 Bitu mem_strlen(PhysPt pt);
 void mem_strcpy(PhysPt dest,PhysPt src);
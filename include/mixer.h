@@ -24,8 +24,11 @@
 #include "dosbox.h"
 #endif
 
+#include <vector>
+
 typedef void (*MIXER_MixHandler)(Bit8u * sampdate,Bit32u len);
 typedef void (*MIXER_Handler)(Bitu len);
+typedef bool (*MIXER_IdleHandler)(void);
 
 enum BlahModes {
 	MIXER_8MONO,MIXER_8STEREO,
@@ -44,6 +47,9 @@ extern Bit8u MixTemp[MIXER_BUFSIZE];
 #define MAX_AUDIO ((1<<(16-1))-1)
 #define MIN_AUDIO -(1<<(16-1))
 
+//Longest sinc filter used to resample channels
+#define MIXER_FIR_MAXTAPS 32
+
 class MixerChannel {
 public:
 	MixerChannel(MIXER_Handler _handler, Bitu _freq, const char * _name);
@@ -80,6 +86,10 @@ public:
 
 	void FillUp(void);
 	void Enable(bool should_enable);
+	// Disable the channel once its output has been silent for silence_ms
+	// and the optional idle handler agrees, the device re-enables it on
+	// its next port write
+	void SetSleep(Bitu silence_ms, MIXER_IdleHandler idle = nullptr);
 	void FlushSamples();
 
 	float volmain[2] = {0.0f, 0.0f};
@@ -90,6 +100,14 @@ public:
 
 private:
 	MixerChannel();
+	template<class Type,bool stereo,bool signeddata,bool nativeorder>
+	void AddSamplesDirect(Bitu len, const Type* data);
+	template<class Type,bool stereo,bool signeddata,bool nativeorder>
+	void TrackSilence(Bitu len, const Type* data);
+	void ClearFilter();
+	void PushFilter(Bitu channel, Bits sample);
+	Bits Filter(Bitu channel, Bitu counter) const;
+
 	MIXER_Handler handler = nullptr;
 	Bitu freq_add = 0u; // This gets added the frequency counter each mixer
 	                    // step
@@ -105,6 +123,16 @@ private:
 	float scale[2] = {0.0f, 0.0f};
 	uint8_t channel_map[2] = {0u, 0u}; // Output channel mapping
 	bool interpolate = false;
+	// Band-limited resampling through a polyphase sinc filter, replaces
+	// the linear interpolation when the mixer has one selected
+	std::vector<int32_t> fir_coefs = {}; // taps for every phase
+	Bitu fir_taps = 0u;
+	Bitu fir_freq = 0u; // rate the filter was made for
+	Bitu fir_pos = 0u;
+	int32_t fir_history[2][2 * MIXER_FIR_MAXTAPS] = {{0}}; // stored twice
+	MIXER_IdleHandler sleep_idle = nullptr;
+	Bitu sleep_after = 0u; // ms of silence before going to sleep, 0 never
+	Bitu last_sound = 0u; // PIC_Ticks of the last audible samples
 	bool last_samples_were_stereo = false;
 	bool last_samples_were_silence = true;
 };
@@ -31,6 +31,11 @@
 // NOTE: does not work with the dynamic core (dynrec is fine)
 #define USE_FULL_TLB
 
+// with USE_FULL_TLB disabled, enable this to use a small set associative TLB
+// instead of the banked one. Pages that are not in the TLB are initialized
+// again on access, so the TLB only needs a few dozen kilobytes
+//#define USE_ASSOC_TLB
+
 class PageDirectory;
 
 #define MEM_PAGE_SIZE	(4096)
@@ -38,6 +43,11 @@ class PageDirectory;
 
 #if defined(USE_FULL_TLB)
 #define TLB_SIZE		(1024*1024)
+#elif defined(USE_ASSOC_TLB)
+#define TLB_SIZE		(1024*1024)	// number of linear pages
+#define TLB_SETS		256			// This must be a power of 2
+#define TLB_WAYS		4			// This must be a power of 2
+#define TLB_INVALID		0xffffffff	// tag of an unused entry
 #else
 #define TLB_SIZE		65536	// This must a power of 2 and greater then LINK_START
 #define BANK_SHIFT		28
@@ -58,6 +68,7 @@ class PageDirectory;
 
 //Allow 128 mb of memory to be linked
 #define PAGING_LINKS (128*1024/4)
+#define PAGING_LINK_GLOBAL	0x80000000
 
 class PageHandler {
 public:
@@ -85,6 +96,7 @@ bool PAGING_Enabled(void);
 
 Bitu PAGING_GetDirBase(void);
 void PAGING_SetDirBase(Bitu cr3);
+void PAGING_SetCR4(Bitu cr4);
 void PAGING_InitTLB(void);
 void PAGING_ClearTLB(void);
 
@@ -96,6 +108,15 @@ void PAGING_MapPage(Bitu lin_page,Bitu phys_page);
 bool PAGING_MakePhysPage(Bitu & page);
 bool PAGING_ForcePageInit(Bitu lin_addr);
 
+struct PagingTLBStats {
+	Bitu flushes;					// TLB flushes, global pages may have been kept
+	Bitu init_faults;				// pages linked by the init handler
+	Bitu flushes_per_second;		// during the last second
+	Bitu init_faults_per_second;
+	Bitu global_links;				// links kept by the last flush
+};
+void PAGING_GetTLBStats(PagingTLBStats & stats);
+
 void MEM_SetLFB(Bitu page, Bitu pages, PageHandler *handler, PageHandler *mmiohandler);
 void MEM_SetPageHandler(Bitu phys_page, Bitu pages, PageHandler * handler);
 void MEM_ResetPageHandler(Bitu phys_page, Bitu pages);
@@ -148,12 +169,16 @@ typedef struct {
 	PageHandler * readhandler;
 	PageHandler * writehandler;
 	Bit32u phys_page;
+#if defined(USE_ASSOC_TLB)
+	Bit32u lin_page;
+#endif
 } tlb_entry;
 #endif
 
 struct PagingBlock {
 	Bitu			cr3;
 	Bitu			cr2;
+	Bitu			cr4;
 	struct {
 		Bitu page;
 		PhysPt addr;
@@ -166,13 +191,17 @@ struct PagingBlock {
 		PageHandler * writehandler[TLB_SIZE];
 		Bit32u	phys_page[TLB_SIZE];
 	} tlb;
+#elif defined(USE_ASSOC_TLB)
+	tlb_entry tlba[TLB_SETS*TLB_WAYS];
+	tlb_entry tlb_miss;				// returned for all pages that are not in the TLB
+	Bit8u tlb_victim[TLB_SETS];		// next way to replace in each set
 #else
 	tlb_entry tlbh[TLB_SIZE];
 	tlb_entry *tlbh_banks[TLB_BANKS];
 #endif
 	struct {
 		Bitu used;
-		Bit32u entries[PAGING_LINKS];
+		Bit32u entries[PAGING_LINKS];	// linked pages, PAGING_LINK_GLOBAL marks global pages
 	} links;
 	Bit32u		firstmb[LINK_START];
 	bool		enabled;
@@ -220,6 +249,18 @@ static INLINE PhysPt PAGING_GetPhysicalAddress(PhysPt linAddr) {
 	return (paging.tlb.phys_page[linAddr>>12]<<12)|(linAddr&0xfff);
 }
 
+#elif defined(USE_ASSOC_TLB)
+
+static INLINE tlb_entry *get_tlb_entry(PhysPt address) {
+	const Bit32u lin_page=address>>12;
+	tlb_entry *set=&paging.tlba[(lin_page & (TLB_SETS-1))*TLB_WAYS];
+	for (Bitu way=0;way<TLB_WAYS;way++) {
+		if (set[way].lin_page==lin_page) return &set[way];
+	}
+	// the miss entry points to the init handler, which links the page
+	return &paging.tlb_miss;
+}
+
 #else
 
 void PAGING_InitTLBBank(tlb_entry **bank);
@@ -235,6 +276,10 @@ static INLINE tlb_entry *get_tlb_entry(PhysPt address) {
 	return &paging.tlbh[index];
 }
 
+#endif
+
+#if !defined(USE_FULL_TLB)
+
 static INLINE HostPt get_tlb_read(PhysPt address) {
 	return get_tlb_entry(address)->read;
 }
@@ -54,10 +54,25 @@ void PIC_DeActivateIRQ(Bitu irq);
 void PIC_runIRQs(void);
 bool PIC_RunQueue(void);
 
+//Handle to a single scheduled event, 0 never refers to an event
+typedef Bit64u PIC_EventId;
+
 //Delay in milliseconds
-void PIC_AddEvent(PIC_EventHandler handler,float delay,Bitu val=0);
+PIC_EventId PIC_AddEvent(PIC_EventHandler handler,float delay,Bitu val=0);
+void PIC_RemoveEvent(PIC_EventId id);
 void PIC_RemoveEvents(PIC_EventHandler handler);
 void PIC_RemoveSpecificEvents(PIC_EventHandler handler, Bitu val);
 
+struct PIC_EventStats {
+	Bit64u added;				//Events scheduled since startup
+	Bit64u dispatched;			//Events run since startup
+	Bitu events_per_second;		//Events run during the last emulated second
+	double average_depth;		//Average pending events during the last emulated second
+	Bitu peak_depth;
+	Bitu pool_size;
+};
+
+const PIC_EventStats & PIC_GetEventStats(void);
+
 void PIC_SetIRQMask(Bitu irq, bool masked);
 #endif
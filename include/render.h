@@ -89,6 +89,7 @@ typedef struct {
 	bool aspect;
 	bool fullFrame;
 	bool forceUpdate;
+	bool nodraw;
 } Render_t;
 
 extern Render_t render;
@@ -50,6 +50,7 @@ typedef void (*GFX_CallBack_t)( GFX_CallBackFunctions_t function );
 
 #define GFX_CAN_RANDOM  0x4000 //If the interface can also do random access surface
 #define GFX_UNITY_SCALE 0x8000 /* turn of all scaling in render.cpp */
+#define GFX_NODRAW      0x10000 /* output is discarded, only render for captures */
 
 void GFX_Events(void);
 Bitu GFX_GetBestMode(Bitu flags);
@@ -50,6 +50,7 @@
 #include "paging.h"
 #include "inout.h"
 #include "fpu.h"
+#include "dyn_profile.h"
 
 #define CACHE_MAXSIZE	(4096*3)
 #define CACHE_TOTAL		(1024*1024*8)
@@ -61,6 +62,7 @@
 #define DYN_LINKS		(16)
 
 //#define DYN_LOG 1 //Turn logging on
+//#define DYN_PROFILE 1 //Count executions and host time per block, see dyn_profile.h
 
 
 #if C_FPU
@@ -303,6 +305,9 @@ restart_core:
 run_block:
 	cache.block.running=0;
 	BlockReturn ret=gen_runcode(block->cache.start);
+#if DYN_PROFILE
+	DYN_ProfileLeave();
+#endif
 #if C_DEBUG
 	cycle_count += 32;
 #endif
@@ -465,6 +470,9 @@ void CPU_Core_Dyn_X86_Cache_Init(bool enable_cache) {
 }
 
 void CPU_Core_Dyn_X86_Cache_Close(void) {
+#if DYN_PROFILE
+	DYN_ProfileReport(20);
+#endif
 	cache_close();
 }
 
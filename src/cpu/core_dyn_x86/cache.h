@@ -52,6 +52,9 @@ public:
 		CacheBlock * from;
 	} link[2];
 	CacheBlock * crossblock;
+#if DYN_PROFILE
+	DynProfileBlock * profile;		//Profile record, only set for the first block of a translation
+#endif
 };
 
 static struct {
@@ -107,6 +110,9 @@ public:
 				CacheBlock * nextblock=block->hash.next;
 				if (start<=block->page.end && end>=block->page.start) {
 					if (ip_point<=block->page.end && ip_point>=block->page.start) is_current_block=true;
+#if DYN_PROFILE
+					if (block->profile) block->profile->invalidations++;
+#endif
 					block->Clear();
 				}
 				block=nextblock;
@@ -370,6 +376,9 @@ static CacheBlock * cache_getblock(void) {
 	if (!ret) E_Exit("Ran out of CacheBlocks" );
 	cache.block.free=ret->cache.next;
 	ret->cache.next=0;
+#if DYN_PROFILE
+	ret->profile=0;
+#endif
 	return ret;
 }
 
@@ -2132,6 +2132,10 @@ static CacheBlock * CreateCacheBlock(CodePageHandler * codepage,PhysPt start,Bit
 	}
 	gen_reinit();
 	gen_save_host_direct(&cache.block.running,(Bitu)decode.block);
+#if DYN_PROFILE
+	decode.block->profile=DYN_ProfileTranslate(start,SegValue(cs),reg_eip);
+	gen_call_function((void *)&DYN_ProfileEnter,"%Ip",decode.block->profile);
+#endif
 	/* Start with the cycles check */
 	gen_protectflags();
 	gen_dop_word(DOP_TEST,true,DREG(CYCLES),DREG(CYCLES));
@@ -2845,6 +2849,9 @@ illegalopcode:
 finish_block:
 	/* Setup the correct end-address */
 	decode.active_block->page.end=--decode.page.index;
+#if DYN_PROFILE
+	decode.block->profile->size=decode.code-decode.code_start;
+#endif
 //	LOG_MSG("Created block size %d start %d end %d",decode.block->cache.size,decode.block->page.start,decode.block->page.end);
 	return decode.block;
 }
@@ -52,18 +52,22 @@
 #include "inout.h"
 #include "lazyflags.h"
 #include "pic.h"
+#include "dyn_profile.h"
 
 #define CACHE_MAXSIZE	(4096*2)
 #define CACHE_TOTAL		(1024*1024*8)
 #define CACHE_PAGES		(512)
 #define CACHE_BLOCKS	(128*1024)
 #define CACHE_ALIGN		(16)
+#define CACHE_SPARE_MAX	(256)	// maximum number of recently run blocks skipped per allocation
+#define CACHE_AGE_SHIFT	(2)		// execution counts are divided by 4 every time a block is skipped
 #define DYN_HASH_SHIFT	(4)
 #define DYN_PAGE_HASH	(4096>>DYN_HASH_SHIFT)
 #define DYN_LINKS		(16)
 
 
 //#define DYN_LOG 1 //Turn Logging on.
+//#define DYN_PROFILE 1 //Count executions and host time per block, see dyn_profile.h
 
 
 #if C_FPU
@@ -255,6 +259,9 @@ run_block:
 		// now we're ready to run the dynamic code block
 //		BlockReturn ret=((BlockReturn (*)(void))(block->cache.start))();
 		BlockReturn ret=core_dynrec.runcode(block->cache.start);
+#if DYN_PROFILE
+		DYN_ProfileLeave();
+#endif
 
 		switch (ret) {
 		case BR_Iret:
@@ -352,12 +359,29 @@ Bits CPU_Core_Dynrec_Trap_Run(void) {
 void CPU_Core_Dynrec_Init(void) {
 }
 
+void CPU_Core_Dynrec_SetCacheSize(Bitu megabytes) {
+	// only has an effect before the code cache is allocated
+	if (cache_code_start_ptr) return;
+	if (megabytes<2) megabytes=2;
+	cache_total=megabytes*1024*1024;
+	// keep the same number of cache blocks per megabyte of code cache
+	cache_block_count=(CACHE_BLOCKS/(CACHE_TOTAL/(1024*1024)))*megabytes;
+}
+
 void CPU_Core_Dynrec_Cache_Init(bool enable_cache) {
 	// Initialize code cache and dynamic blocks
 	cache_init(enable_cache);
 }
 
+void CPU_Core_Dynrec_GetFlagsStats(Bitu & queued,Bitu & eliminated) {
+	queued=mf_stats.queued;
+	eliminated=mf_stats.eliminated;
+}
+
 void CPU_Core_Dynrec_Cache_Close(void) {
+#if DYN_PROFILE
+	DYN_ProfileReport(20);
+#endif
 	cache_close();
 }
 
@@ -59,6 +59,10 @@ public:
 		CacheBlockDynRec * from;	// the from-block can transfer control to this block
 	} link[2];	// maximum two links (conditional jumps)
 	CacheBlockDynRec * crossblock;
+	Bit32u exec_count;		// executions since the block was last passed by the cache ring
+#if DYN_PROFILE
+	DynProfileBlock * profile;		// profile record, only set for the first block of a translation
+#endif
 };
 
 static struct {
@@ -80,6 +84,8 @@ static uint8_t *cache_code = nullptr;
 static uint8_t *cache_code_link_blocks = nullptr;
 
 static CacheBlockDynRec *cache_blocks = nullptr;
+static Bitu cache_total = CACHE_TOTAL;			// size of the code cache
+static Bitu cache_block_count = CACHE_BLOCKS;	// number of allocated cache blocks
 static CacheBlockDynRec link_blocks[2];		// default linking (specially marked)
 
 // the CodePageHandlerDynRec class provides access to the contained
@@ -130,6 +136,9 @@ public:
 				// test if this block is in the range
 				if (start<=block->page.end && end>=block->page.start) {
 					if (ip_point<=block->page.end && ip_point>=block->page.start) is_current_block=true;
+#if DYN_PROFILE
+					if (block->profile) block->profile->invalidations++;
+#endif
 					block->Clear();		// clear the block, decrements the write_map accordingly
 				}
 				block=nextblock;
@@ -394,6 +403,10 @@ static CacheBlockDynRec * cache_getblock(void) {
 	if (!ret) E_Exit("Ran out of CacheBlocks" );
 	cache.block.free=ret->cache.next;
 	ret->cache.next=0;
+	ret->exec_count=0;
+#if DYN_PROFILE
+	ret->profile=0;
+#endif
 	return ret;
 }
 
@@ -445,30 +458,66 @@ void CacheBlockDynRec::Clear(void) {
 }
 
 
+// the cache block that follows in the ring of cache memory
+static INLINE CacheBlockDynRec * cache_ringnext(CacheBlockDynRec * block) {
+	CacheBlockDynRec * next=block->cache.next;
+	if (!next || (next->cache.start>(cache_code_start_ptr + cache_total - CACHE_MAXSIZE))) {
+//		LOG_MSG("Cache full restarting");
+		return cache.block.first;
+	}
+	return next;
+}
+
+// blocks that were executed since the ring last passed them get a second chance,
+// their execution count is aged so only blocks that keep running stay in the cache
+static INLINE bool cache_spareblock(CacheBlockDynRec * block,Bitu spared) {
+	return block->page.handler && block->exec_count && (spared<CACHE_SPARE_MAX);
+}
+
 static CacheBlockDynRec * cache_openblock(void) {
 	CacheBlockDynRec * block=cache.block.active;
-	// check for enough space in this block
-	Bitu size=block->cache.size;
-	CacheBlockDynRec * nextblock=block->cache.next;
-	if (block->page.handler)
-		block->Clear();
-	// block size must be at least CACHE_MAXSIZE
-	while (size<CACHE_MAXSIZE) {
-		if (!nextblock)
-			goto skipresize;
-		// merge blocks
-		size+=nextblock->cache.size;
-		CacheBlockDynRec * tempblock=nextblock->cache.next;
-		if (nextblock->page.handler)
-			nextblock->Clear();
-		// block is free now
-		cache_add_unused_block(nextblock);
-		nextblock=tempblock;
+	Bitu spared=0;
+	Bitu size;
+	CacheBlockDynRec * nextblock;
+	for (;;) {
+		if (cache_spareblock(block,spared)) {
+			block->exec_count>>=CACHE_AGE_SHIFT;
+			spared++;
+			block=cache_ringnext(block);
+			continue;
+		}
+		// check for enough space in this block
+		size=block->cache.size;
+		nextblock=block->cache.next;
+		if (block->page.handler)
+			block->Clear();
+		// block size must be at least CACHE_MAXSIZE
+		while (size<CACHE_MAXSIZE) {
+			if (!nextblock)
+				goto skipresize;
+			// don't evict recently run blocks while merging
+			if (cache_spareblock(nextblock,spared)) break;
+			// merge blocks
+			size+=nextblock->cache.size;
+			CacheBlockDynRec * tempblock=nextblock->cache.next;
+			if (nextblock->page.handler)
+				nextblock->Clear();
+			// block is free now
+			cache_add_unused_block(nextblock);
+			nextblock=tempblock;
+		}
+		if (size>=CACHE_MAXSIZE) break;
+		// keep the freed space and continue behind the recently run block
+		block->cache.size=size;
+		block->cache.next=nextblock;
+		block=cache_ringnext(block);
 	}
 skipresize:
 	// adjust parameters and open this block
 	block->cache.size=size;
 	block->cache.next=nextblock;
+	block->exec_count=0;
+	cache.block.active=block;
 	cache.pos=block->cache.start;
 	return block;
 }
@@ -509,12 +558,7 @@ static void cache_closeblock(void) {
 		}
 	}
 	// advance the active block pointer
-	if (!block->cache.next || (block->cache.next->cache.start>(cache_code_start_ptr + CACHE_TOTAL - CACHE_MAXSIZE))) {
-//		LOG_MSG("Cache full restarting");
-		cache.block.active=cache.block.first;
-	} else {
-		cache.block.active=block->cache.next;
-	}
+	cache.block.active=cache_ringnext(block);
 }
 
 
@@ -565,12 +609,12 @@ static void cache_init(bool enable) {
 		cache_initialized = true;
 		if (cache_blocks == NULL) {
 			// allocate the cache blocks memory
-			cache_blocks=(CacheBlockDynRec*)malloc(CACHE_BLOCKS*sizeof(CacheBlockDynRec));
+			cache_blocks=(CacheBlockDynRec*)malloc(cache_block_count*sizeof(CacheBlockDynRec));
 			if(!cache_blocks) E_Exit("Allocating cache_blocks has failed");
-			memset(cache_blocks,0,sizeof(CacheBlockDynRec)*CACHE_BLOCKS);
+			memset(cache_blocks,0,sizeof(CacheBlockDynRec)*cache_block_count);
 			cache.block.free=&cache_blocks[0];
 			// initialize the cache blocks
-			for (i=0;i<CACHE_BLOCKS-1;i++) {
+			for (i=0;i<(Bits)cache_block_count-1;i++) {
 				cache_blocks[i].link[0].to=(CacheBlockDynRec *)1;
 				cache_blocks[i].link[1].to=(CacheBlockDynRec *)1;
 				cache_blocks[i].cache.next=&cache_blocks[i+1];
@@ -579,12 +623,12 @@ static void cache_init(bool enable) {
 		if (cache_code_start_ptr==NULL) {
 			// allocate the code cache memory
 #if defined (WIN32)
-			cache_code_start_ptr=(Bit8u*)VirtualAlloc(0,CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
+			cache_code_start_ptr=(Bit8u*)VirtualAlloc(0,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
 				MEM_COMMIT,PAGE_EXECUTE_READWRITE);
 			if (!cache_code_start_ptr)
-				cache_code_start_ptr=(Bit8u*)malloc(CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+				cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
 #else
-			cache_code_start_ptr=(Bit8u*)malloc(CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+			cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
 #endif
 			if(!cache_code_start_ptr) E_Exit("Allocating dynamic cache failed");
 
@@ -595,14 +639,14 @@ static void cache_init(bool enable) {
 			cache_code=cache_code+PAGESIZE_TEMP;
 
 #if (C_HAVE_MPROTECT)
-			if(mprotect(cache_code_link_blocks,CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP,PROT_WRITE|PROT_READ|PROT_EXEC))
+			if(mprotect(cache_code_link_blocks,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP,PROT_WRITE|PROT_READ|PROT_EXEC))
 				LOG_MSG("Setting execute permission on the code cache has failed");
 #endif
 			CacheBlockDynRec * block=cache_getblock();
 			cache.block.first=block;
 			cache.block.active=block;
 			block->cache.start=&cache_code[0];
-			block->cache.size=CACHE_TOTAL;
+			block->cache.size=cache_total;
 			block->cache.next=0;						// last block in the list
 		}
 		// setup the default blocks for block linkage returns
@@ -49,6 +49,13 @@ static CacheBlockDynRec * CreateCacheBlock(CodePageHandlerDynRec * codepage,Phys
 	// every codeblock that is run sets cache.block.running to itself
 	// so the block linking knows the last executed block
 	gen_mov_direct_ptr(&cache.block.running,(DRC_PTR_SIZE_IM)decode.block);
+	// count the executions so recently run blocks survive cache recycling
+	gen_add_direct_word(&decode.block->exec_count,1,true);
+
+#if DYN_PROFILE
+	decode.block->profile=DYN_ProfileTranslate(start,SegValue(cs),reg_eip);
+	gen_call_function_A((void*)&DYN_ProfileEnter,(DRC_PTR_SIZE_IM)decode.block->profile);
+#endif
 
 	// start with the cycles check
 	gen_mov_word_to_reg(FC_RETOP,&CPU_Cycles,true);
@@ -514,17 +521,23 @@ restart_prefix:
 			dyn_call_near_imm();
 			goto finish_block;
 		// 'jmp near imm16/32'
-		case 0xe9:
-			dyn_exit_link(decode.big_op ? (Bit32s)decode_fetchd() : (Bit16s)decode_fetchw());
+		case 0xe9: {
+			Bits eip_change=decode.big_op ? (Bit32s)decode_fetchd() : (Bit16s)decode_fetchw();
+			if (dyn_follow_jump(eip_change)) break;
+			dyn_exit_link(eip_change);
 			goto finish_block;
+			}
 		// 'jmp far'
 		case 0xea:
 			dyn_jmp_far_imm();
 			goto finish_block;
 		// 'jmp short imm8'
-		case 0xeb:
-			dyn_exit_link((Bit8s)decode_fetchb());
+		case 0xeb: {
+			Bits eip_change=(Bit8s)decode_fetchb();
+			if (dyn_follow_jump(eip_change)) break;
+			dyn_exit_link(eip_change);
 			goto finish_block;
+			}
 
 
 		// repeat prefixes
@@ -611,6 +624,9 @@ finish_block:
 	// setup the correct end-address
 	decode.page.index--;
 	decode.active_block->page.end=(Bit16u)decode.page.index;
+#if DYN_PROFILE
+	decode.block->profile->size=decode.code-decode.block->profile->start;
+#endif
 //	LOG_MSG("Created block size %d start %d end %d",decode.block->cache.size,decode.block->page.start,decode.block->page.end);
 
 	return decode.block;
@@ -550,6 +550,11 @@ static DRC_PTR_SIZE_IM INLINE gen_call_function_I(void * func,Bitu op) {
 	return gen_call_function_setup(func, 1);
 }
 
+static DRC_PTR_SIZE_IM INLINE gen_call_function_A(void * func,DRC_PTR_SIZE_IM op) {
+	gen_load_param_addr(op,0);
+	return gen_call_function_setup(func, 1);
+}
+
 static DRC_PTR_SIZE_IM INLINE gen_call_function_II(void * func,Bitu op1,Bitu op2) {
 	gen_load_param_imm(op2,1);
 	gen_load_param_imm(op1,0);
@@ -1219,18 +1224,33 @@ static struct {
 	Bitu ftype;
 } mf_functions[64];
 
+// number of flag generating functions that were queued and
+// how many of them have been replaced by simpler variants
+static struct {
+	Bitu queued;
+	Bitu eliminated;
+} mf_stats;
+
 static void InitFlagsOptimization(void) {
 	mf_functions_num=0;
 }
 
+#ifdef DRC_FLAGS_INVALIDATION
+// replace the queued functions, the condition flags they generate are dead
+static void ReplaceQueuedFlagsFunctions(void) {
+	for (Bitu ct=0; ct<mf_functions_num; ct++) {
+		gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
+	}
+	mf_stats.eliminated+=mf_functions_num;
+}
+#endif
+
 // replace all queued functions with their simpler variants
 // because the current instruction destroys all condition flags and
 // the flags are not required before
 static void InvalidateFlags(void) {
 #ifdef DRC_FLAGS_INVALIDATION
-	for (Bitu ct=0; ct<mf_functions_num; ct++) {
-		gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
-	}
+	ReplaceQueuedFlagsFunctions();
 	mf_functions_num=0;
 #endif
 }
@@ -1240,10 +1260,9 @@ static void InvalidateFlags(void) {
 // the flags are not required before
 static void InvalidateFlags(void* current_simple_function,Bitu flags_type) {
 #ifdef DRC_FLAGS_INVALIDATION
-	for (Bitu ct=0; ct<mf_functions_num; ct++) {
-		gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
-	}
+	ReplaceQueuedFlagsFunctions();
 	mf_functions_num=1;
+	mf_stats.queued++;
 	mf_functions[0].pos=cache.pos;
 	mf_functions[0].fct_ptr=current_simple_function;
 	mf_functions[0].ftype=flags_type;
@@ -1255,6 +1274,9 @@ static void InvalidateFlags(void* current_simple_function,Bitu flags_type) {
 // this function can be replaced by a simpler one as well
 static void InvalidateFlagsPartially(void* current_simple_function,Bitu flags_type) {
 #ifdef DRC_FLAGS_INVALIDATION
+	// queue full, the function keeps generating flags
+	if (mf_functions_num>=sizeof(mf_functions)/sizeof(mf_functions[0])) return;
+	mf_stats.queued++;
 	mf_functions[mf_functions_num].pos=cache.pos;
 	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
 	mf_functions[mf_functions_num].ftype=flags_type;
@@ -1267,6 +1289,8 @@ static void InvalidateFlagsPartially(void* current_simple_function,Bitu flags_ty
 // this function can be replaced by a simpler one as well
 static void InvalidateFlagsPartially(void* current_simple_function,DRC_PTR_SIZE_IM cpos,Bitu flags_type) {
 #ifdef DRC_FLAGS_INVALIDATION
+	if (mf_functions_num>=sizeof(mf_functions)/sizeof(mf_functions[0])) return;
+	mf_stats.queued++;
 	mf_functions[mf_functions_num].pos=(Bit8u*)cpos;
 	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
 	mf_functions[mf_functions_num].ftype=flags_type;
@@ -1102,6 +1102,24 @@ static void dyn_exit_link(Bits eip_change) {
 }
 
 
+// continue the translation at the target of a forward jump inside the current page,
+// only eip is advanced so the jump costs no block exit and link
+static bool dyn_follow_jump(Bits eip_change) {
+	// 16bit code is excluded as eip wraps around at 64k
+	if (!cpu.code.big || !decode.big_op || (eip_change<0)) return false;
+	if (decode.page.index+eip_change>=4096) return false;
+	gen_add_direct_word(&reg_eip,(decode.code-decode.code_start)+eip_change,true);
+	// the skipped bytes still lie inside the block range that gets released
+	// from the write map, so count them as code like fetched bytes
+	for (Bits i=0;i<eip_change;i++) decode.page.wmap[decode.page.index+i]+=0x01;
+	decode.code+=eip_change;
+	decode.page.index+=eip_change;
+	// further eip changes are relative to the jump target
+	decode.code_start=decode.code;
+	return true;
+}
+
+
 static void dyn_branched_exit(BranchTypes btype,Bit32s eip_add) {
 	Bitu eip_base=decode.code-decode.code_start;
 	dyn_reduce_cycles();
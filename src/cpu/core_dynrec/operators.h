@@ -1650,6 +1650,13 @@ static Bit16u DRC_CALL_CONV dynrec_movsb_word(Bit16u count,Bit16s add_index,Phys
 		count=(Bit16u)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu si_index=reg_si,di_index=reg_di;
+		MEM_StringMove(si_base,si_index,di_base,di_index,0xffff,count,1);
+		reg_si=(Bit16u)si_index;
+		reg_di=(Bit16u)di_index;
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_di,mem_readb(si_base+reg_si));
 		reg_si+=add_index;
@@ -1668,6 +1675,13 @@ static Bit32u DRC_CALL_CONV dynrec_movsb_dword(Bit32u count,Bit32s add_index,Phy
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu si_index=reg_esi,di_index=reg_edi;
+		MEM_StringMove(si_base,si_index,di_base,di_index,0xffffffff,count,1);
+		reg_esi=(Bit32u)si_index;
+		reg_edi=(Bit32u)di_index;
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_edi,mem_readb(si_base+reg_esi));
 		reg_esi+=add_index;
@@ -1686,6 +1700,13 @@ static Bit16u DRC_CALL_CONV dynrec_movsw_word(Bit16u count,Bit16s add_index,Phys
 		count=(Bit16u)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu si_index=reg_si,di_index=reg_di;
+		MEM_StringMove(si_base,si_index,di_base,di_index,0xffff,count,2);
+		reg_si=(Bit16u)si_index;
+		reg_di=(Bit16u)di_index;
+		return count_left;
+	}
 	add_index<<=1;
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_di,mem_readw(si_base+reg_si));
@@ -1705,6 +1726,13 @@ static Bit32u DRC_CALL_CONV dynrec_movsw_dword(Bit32u count,Bit32s add_index,Phy
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu si_index=reg_esi,di_index=reg_edi;
+		MEM_StringMove(si_base,si_index,di_base,di_index,0xffffffff,count,2);
+		reg_esi=(Bit32u)si_index;
+		reg_edi=(Bit32u)di_index;
+		return count_left;
+	}
 	add_index<<=1;
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_edi,mem_readw(si_base+reg_esi));
@@ -1724,6 +1752,13 @@ static Bit16u DRC_CALL_CONV dynrec_movsd_word(Bit16u count,Bit16s add_index,Phys
 		count=(Bit16u)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu si_index=reg_si,di_index=reg_di;
+		MEM_StringMove(si_base,si_index,di_base,di_index,0xffff,count,4);
+		reg_si=(Bit16u)si_index;
+		reg_di=(Bit16u)di_index;
+		return count_left;
+	}
 	add_index<<=2;
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_di,mem_readd(si_base+reg_si));
@@ -1743,6 +1778,13 @@ static Bit32u DRC_CALL_CONV dynrec_movsd_dword(Bit32u count,Bit32s add_index,Phy
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu si_index=reg_esi,di_index=reg_edi;
+		MEM_StringMove(si_base,si_index,di_base,di_index,0xffffffff,count,4);
+		reg_esi=(Bit32u)si_index;
+		reg_edi=(Bit32u)di_index;
+		return count_left;
+	}
 	add_index<<=2;
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_edi,mem_readd(si_base+reg_esi));
@@ -1870,6 +1912,12 @@ static Bit16u DRC_CALL_CONV dynrec_stosb_word(Bit16u count,Bit16s add_index,Phys
 		count=(Bit16u)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu di_index=reg_di;
+		MEM_StringStore(di_base,di_index,0xffff,count,1,reg_al);
+		reg_di=(Bit16u)di_index;
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_di,reg_al);
 		reg_di+=add_index;
@@ -1887,6 +1935,12 @@ static Bit32u DRC_CALL_CONV dynrec_stosb_dword(Bit32u count,Bit32s add_index,Phy
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu di_index=reg_edi;
+		MEM_StringStore(di_base,di_index,0xffffffff,count,1,reg_al);
+		reg_edi=(Bit32u)di_index;
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_edi,reg_al);
 		reg_edi+=add_index;
@@ -1904,6 +1958,12 @@ static Bit16u DRC_CALL_CONV dynrec_stosw_word(Bit16u count,Bit16s add_index,Phys
 		count=(Bit16u)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu di_index=reg_di;
+		MEM_StringStore(di_base,di_index,0xffff,count,2,reg_ax);
+		reg_di=(Bit16u)di_index;
+		return count_left;
+	}
 	add_index<<=1;
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_di,reg_ax);
@@ -1922,6 +1982,12 @@ static Bit32u DRC_CALL_CONV dynrec_stosw_dword(Bit32u count,Bit32s add_index,Phy
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu di_index=reg_edi;
+		MEM_StringStore(di_base,di_index,0xffffffff,count,2,reg_ax);
+		reg_edi=(Bit32u)di_index;
+		return count_left;
+	}
 	add_index<<=1;
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_edi,reg_ax);
@@ -1940,6 +2006,12 @@ static Bit16u DRC_CALL_CONV dynrec_stosd_word(Bit16u count,Bit16s add_index,Phys
 		count=(Bit16u)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu di_index=reg_di;
+		MEM_StringStore(di_base,di_index,0xffff,count,4,reg_eax);
+		reg_di=(Bit16u)di_index;
+		return count_left;
+	}
 	add_index<<=2;
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_di,reg_eax);
@@ -1958,6 +2030,12 @@ static Bit32u DRC_CALL_CONV dynrec_stosd_dword(Bit32u count,Bit32s add_index,Phy
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index>0) {
+		Bitu di_index=reg_edi;
+		MEM_StringStore(di_base,di_index,0xffffffff,count,4,reg_eax);
+		reg_edi=(Bit32u)di_index;
+		return count_left;
+	}
 	add_index<<=2;
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_edi,reg_eax);
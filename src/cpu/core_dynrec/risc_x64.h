@@ -80,6 +80,17 @@ typedef Bit8u HostReg;
 // temporary register for LEA
 #define TEMP_REG_DRC HOST_ESI
 
+// r15 holds the address of cpu_regs while generated code runs, the guest
+// registers and the other emulator variables are addressed relative to it
+// when the code cache is too far away from them for rip-relative addressing
+#define HOST_R15_BASE ((Bit64s)&cpu_regs)
+
+// see if data can be addressed relative to r15
+static INLINE bool gen_r15_reachable(void* data,Bit64s & disp) {
+	disp=(Bit64s)data-HOST_R15_BASE;
+	return (disp>>63) == (disp>>31);
+}
+
 
 // move a full register from reg_src to reg_dst
 static void gen_mov_regs(HostReg reg_dst,HostReg reg_src) {
@@ -107,6 +118,16 @@ static INLINE void gen_reg_memaddr(HostReg reg,void* data,Bit8u op,Bit8u prefix=
 		cache_addb(op);
 		cache_addw(0x2504+(reg<<3));
 		cache_addd((Bit32u)(((Bit64u)data)&0xffffffffLL));
+	} else if (gen_r15_reachable(data,diff)) {
+		// mov reg,[r15+diff] (or similar, depending on the op), the rex prefix
+		// has to follow legacy prefixes and precede the 0x0f opcode escape
+		if (prefix==0x48) cache_addb(0x49);
+		else if (prefix==0x0f) cache_addw(0x0f41);
+		else if (prefix) cache_addw(0x4100+prefix);
+		else cache_addb(0x41);
+		cache_addb(op);
+		cache_addb(0x87+(reg<<3));
+		cache_addd((Bit32u)(((Bit64u)diff)&0xffffffffLL));
 	} else {
 		// load 64-bit data into tmp_reg and do mov reg,[tmp_reg] (or similar, depending on the op)
 		HostReg tmp_reg = HOST_EAX;
@@ -151,6 +172,19 @@ static INLINE void gen_memaddr(Bitu modreg,void* data,Bitu off,Bitu imm,Bit8u op
 			case 4: cache_addd(((Bit32u)imm&0xffffffff)); break;
 		}
 
+	} else if (gen_r15_reachable(data,diff)) {
+		// op [r15+diff],imm
+		if (prefix) cache_addb(prefix);
+		cache_addb(0x41);
+		cache_addw(op+((modreg+0x83)<<8));
+		cache_addd((Bit32u)(((Bit64u)diff)&0xffffffffLL));
+
+		switch(off) {
+			case 1: cache_addb(((Bit8u)imm&0xff)); break;
+			case 2: cache_addw(((Bit16u)imm&0xffff)); break;
+			case 4: cache_addd(((Bit32u)imm&0xffffffff)); break;
+		}
+
 	} else {
 		HostReg tmp_reg = HOST_EAX;
 
@@ -604,10 +638,13 @@ static void gen_fill_branch_long(Bit64u data) {
 static void gen_run_code(void) {
 	cache_addw(0x5355);     // push rbp,rbx
 	cache_addb(0x56);       // push rsi
-	cache_addd(0x20EC8348); // sub rsp, 32
+	cache_addw(0x5741);     // push r15
+	cache_addd(0x28EC8348); // sub rsp, 40
+	cache_addw(0xBF49);cache_addq((Bit64u)HOST_R15_BASE); // mov r15, &cpu_regs
 	cache_addb(0x48);cache_addw(0x2D8D);cache_addd(2); // lea rbp, [rip+2]
 	cache_addw(0xE0FF+(FC_OP1<<8)); // jmp FC_OP1
-	cache_addd(0x20C48348); // add rsp, 32
+	cache_addd(0x28C48348); // add rsp, 40
+	cache_addw(0x5F41);     // pop r15
 	cache_addd(0xC35D5B5E); // pop rsi,rbx,rbp;ret
 }
 
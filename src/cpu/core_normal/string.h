@@ -101,12 +101,22 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_STOSB:
+		if (add_index>0) {
+			MEM_StringStore(di_base,di_index,add_mask,count,1,reg_al);
+			count=0;
+			break;
+		}
 		for (;count>0;count--) {
 			SaveMb(di_base+di_index,reg_al);
 			di_index=(di_index+add_index) & add_mask;
 		}
 		break;
 	case R_STOSW:
+		if (add_index>0) {
+			MEM_StringStore(di_base,di_index,add_mask,count,2,reg_ax);
+			count=0;
+			break;
+		}
 		add_index<<=1;
 		for (;count>0;count--) {
 			SaveMw(di_base+di_index,reg_ax);
@@ -114,6 +124,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_STOSD:
+		if (add_index>0) {
+			MEM_StringStore(di_base,di_index,add_mask,count,4,reg_eax);
+			count=0;
+			break;
+		}
 		add_index<<=2;
 		for (;count>0;count--) {
 			SaveMd(di_base+di_index,reg_eax);
@@ -121,6 +136,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_MOVSB:
+		if (add_index>0) {
+			MEM_StringMove(si_base,si_index,di_base,di_index,add_mask,count,1);
+			count=0;
+			break;
+		}
 		for (;count>0;count--) {
 			SaveMb(di_base+di_index,LoadMb(si_base+si_index));
 			di_index=(di_index+add_index) & add_mask;
@@ -128,6 +148,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_MOVSW:
+		if (add_index>0) {
+			MEM_StringMove(si_base,si_index,di_base,di_index,add_mask,count,2);
+			count=0;
+			break;
+		}
 		add_index<<=1;
 		for (;count>0;count--) {
 			SaveMw(di_base+di_index,LoadMw(si_base+si_index));
@@ -136,6 +161,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_MOVSD:
+		if (add_index>0) {
+			MEM_StringMove(si_base,si_index,di_base,di_index,add_mask,count,4);
+			count=0;
+			break;
+		}
 		add_index<<=2;
 		for (;count>0;count--) {
 			SaveMd(di_base+di_index,LoadMd(si_base+si_index));
@@ -79,6 +79,7 @@ void CPU_Core_Dyn_X86_SetFPUMode(bool dh_fpu);
 #elif (C_DYNREC)
 void CPU_Core_Dynrec_Init(void);
 void CPU_Core_Dynrec_Cache_Init(bool enable_cache);
+void CPU_Core_Dynrec_SetCacheSize(Bitu megabytes);
 void CPU_Core_Dynrec_Cache_Close(void);
 #endif
 
@@ -1601,6 +1602,12 @@ void CPU_SET_CRX(Bitu cr,Bitu value) {
 	case 3:
 		PAGING_SetDirBase(value);
 		break;
+	case 4:
+		/* Only page global enable is kept, other bits read back as zero */
+		if (value & ~CR4_PAGEGLOBAL)
+			LOG(LOG_CPU,LOG_ERROR)("Unhandled MOV CR4,%X",value & ~CR4_PAGEGLOBAL);
+		PAGING_SetCR4(value);
+		break;
 	default:
 		LOG(LOG_CPU,LOG_ERROR)("Unhandled MOV CR%d,%X",cr,value);
 		break;
@@ -1628,6 +1635,8 @@ Bitu CPU_GET_CRX(Bitu cr) {
 		return paging.cr2;
 	case 3:
 		return PAGING_GetDirBase() & 0xfffff000;
+	case 4:
+		return paging.cr4;
 	default:
 		LOG(LOG_CPU,LOG_ERROR)("Unhandled MOV XXX, CR%d",cr);
 		break;
@@ -2013,7 +2022,7 @@ bool CPU_CPUID(void) {
 			reg_eax=0x513;		/* intel pentium */
 			reg_ebx=0;			/* Not Supported */
 			reg_ecx=0;			/* No features */
-			reg_edx=0x00000011;	/* FPU+TimeStamp/RDTSC */
+			reg_edx=0x00002011;	/* FPU+TimeStamp/RDTSC+PGE */
 		} else {
 			return false;
 		}
@@ -2334,6 +2343,7 @@ public:
 #if (C_DYNAMIC_X86)
 		CPU_Core_Dyn_X86_Cache_Init((core == "dynamic") || (core == "dynamic_nodhfpu"));
 #elif (C_DYNREC)
+		CPU_Core_Dynrec_SetCacheSize(section->Get_int("dynamic_cache"));
 		CPU_Core_Dynrec_Cache_Init( core == "dynamic" );
 #endif
 
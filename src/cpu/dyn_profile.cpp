@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dyn_profile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+typedef std::chrono::steady_clock dyn_profile_clock;
+
+static std::unordered_map<PhysPt,DynProfileBlock> profile_blocks;
+static DynProfileBlock * profile_current = nullptr;
+static dyn_profile_clock::time_point profile_entered;
+
+DynProfileBlock * DYN_ProfileTranslate(PhysPt start,Bit16u cs,Bit32u eip) {
+	DynProfileBlock & block=profile_blocks[start];
+	block.start=start;
+	block.cs=cs;
+	block.eip=eip;
+	block.translations++;
+	return &block;
+}
+
+// called from the generated code whenever a profiled block is entered
+void DYN_ProfileEnter(DynProfileBlock * block) {
+	const dyn_profile_clock::time_point now=dyn_profile_clock::now();
+	if (profile_current) {
+		profile_current->host_ns+=std::chrono::duration_cast<std::chrono::nanoseconds>(now-profile_entered).count();
+	}
+	block->executions++;
+	profile_current=block;
+	profile_entered=now;
+}
+
+// called by the core when the generated code returns to the dispatcher
+void DYN_ProfileLeave(void) {
+	if (!profile_current) return;
+	const dyn_profile_clock::time_point now=dyn_profile_clock::now();
+	profile_current->host_ns+=std::chrono::duration_cast<std::chrono::nanoseconds>(now-profile_entered).count();
+	profile_current=nullptr;
+}
+
+void DYN_ProfileReset(void) {
+	for (auto & entry : profile_blocks) {
+		DynProfileBlock & block=entry.second;
+		block.executions=0;
+		block.host_ns=0;
+		block.invalidations=0;
+	}
+}
+
+void DYN_ProfileReport(Bitu count) {
+	if (profile_blocks.empty()) {
+		LOG_MSG("DYNPROF: no profile data, build the dynamic core with DYN_PROFILE");
+		return;
+	}
+	std::vector<const DynProfileBlock *> sorted;
+	sorted.reserve(profile_blocks.size());
+	Bit64u total_ns=0;
+	for (const auto & entry : profile_blocks) {
+		sorted.push_back(&entry.second);
+		total_ns+=entry.second.host_ns;
+	}
+	count=std::min<Bitu>(count,sorted.size());
+	std::partial_sort(sorted.begin(),sorted.begin()+count,sorted.end(),
+	                  [](const DynProfileBlock * a,const DynProfileBlock * b) {
+		if (a->host_ns!=b->host_ns) return a->host_ns>b->host_ns;
+		return a->executions>b->executions;
+	});
+	LOG_MSG("DYNPROF: top %u of %u blocks by host time",(unsigned)count,(unsigned)sorted.size());
+	LOG_MSG("   CS:EIP        size    executions    host ms  share  trans  inval");
+	for (Bitu i=0;i<count;i++) {
+		const DynProfileBlock * block=sorted[i];
+		LOG_MSG("%04X:%08X  %5u  %12llu  %9.3f  %4.1f%%  %5u  %5u",
+		        block->cs,block->eip,(unsigned)block->size,
+		        (unsigned long long)block->executions,block->host_ns/1000000.0,
+		        total_ns ? 100.0*block->host_ns/total_ns : 0.0,
+		        (unsigned)block->translations,(unsigned)block->invalidations);
+	}
+}
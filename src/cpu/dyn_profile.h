@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef DOSBOX_DYN_PROFILE_H
+#define DOSBOX_DYN_PROFILE_H
+
+#ifndef DOSBOX_DOSBOX_H
+#include "dosbox.h"
+#endif
+#ifndef DOSBOX_MEM_H
+#include "mem.h"
+#endif
+
+/*
+	Execution profile of the dynamic cores. The cores only collect it when
+	they are built with DYN_PROFILE defined (see core_dynrec.cpp and
+	core_dyn_x86.cpp); every translated block then calls DYN_ProfileEnter
+	on entry. Records are kept per linear start address so they survive
+	the block being retranslated.
+*/
+struct DynProfileBlock {
+	PhysPt start;			// linear address of the first instruction
+	Bit16u cs;				// cs:eip at the time of the last translation
+	Bit32u eip;
+	Bitu size;				// guest code bytes covered by the block
+	Bit64u executions;
+	Bit64u host_ns;			// host time spent from entering this block until the next one
+	Bitu translations;
+	Bitu invalidations;		// blocks cleared by writes to their code
+};
+
+DynProfileBlock * DYN_ProfileTranslate(PhysPt start,Bit16u cs,Bit32u eip);
+void DYN_ProfileEnter(DynProfileBlock * block);
+void DYN_ProfileLeave(void);
+void DYN_ProfileReset(void);
+void DYN_ProfileReport(Bitu count);
+
+#endif
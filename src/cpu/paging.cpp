@@ -29,6 +29,7 @@
 #include "cpu.h"
 #include "debug.h"
 #include "setup.h"
+#include "pic.h"
 
 #define LINK_TOTAL		(64*1024)
 
@@ -166,10 +167,59 @@ void PAGING_PageFault(PhysPt lin_addr,Bitu page_addr,Bitu faultcode) {
 //	LOG_MSG("SS:%04x SP:%08X",SegValue(ss),reg_esp);
 }
 
+static struct {
+	Bitu flushes,init_faults;
+	Bitu second_flushes,second_init_faults;	// counted in the current second
+	Bitu last_flushes,last_init_faults;		// counted in the last full second
+	Bitu second_start;
+	Bitu global_links;
+} tlb_stats;
+
+static INLINE void PAGING_StatsSecond(void) {
+	if (GCC_LIKELY(PIC_Ticks-tlb_stats.second_start<1000)) return;
+	if (PIC_Ticks-tlb_stats.second_start<2000) {
+		tlb_stats.last_flushes=tlb_stats.second_flushes;
+		tlb_stats.last_init_faults=tlb_stats.second_init_faults;
+	} else {
+		// nothing happened during the last second
+		tlb_stats.last_flushes=tlb_stats.last_init_faults=0;
+	}
+	tlb_stats.second_flushes=tlb_stats.second_init_faults=0;
+	tlb_stats.second_start=PIC_Ticks;
+}
+
+static INLINE void PAGING_CountFlush(void) {
+	PAGING_StatsSecond();
+	tlb_stats.flushes++;
+	tlb_stats.second_flushes++;
+}
+
+static INLINE void PAGING_CountInitFault(void) {
+	PAGING_StatsSecond();
+	tlb_stats.init_faults++;
+	tlb_stats.second_init_faults++;
+}
+
+void PAGING_GetTLBStats(PagingTLBStats & stats) {
+	PAGING_StatsSecond();
+	stats.flushes=tlb_stats.flushes;
+	stats.init_faults=tlb_stats.init_faults;
+	stats.flushes_per_second=tlb_stats.last_flushes;
+	stats.init_faults_per_second=tlb_stats.last_init_faults;
+	stats.global_links=tlb_stats.global_links;
+}
+
+// mark the page that was just linked as global, it then survives cr3 loads
+static INLINE void InitPageLinkGlobal(Bitu lin_page,X86PageEntry & entry) {
+	if (!entry.block.g || !(paging.cr4 & CR4_PAGEGLOBAL) || !paging.links.used) return;
+	Bit32u & link=paging.links.entries[paging.links.used-1];
+	if (link==lin_page) link|=PAGING_LINK_GLOBAL;
+}
+
 static INLINE void InitPageUpdateLink(Bitu relink,PhysPt addr) {
 	if (relink==0) return;
 	if (paging.links.used) {
-		if (paging.links.entries[paging.links.used-1]==(addr>>12)) {
+		if ((paging.links.entries[paging.links.used-1] & ~PAGING_LINK_GLOBAL)==(addr>>12)) {
 			paging.links.used--;
 			PAGING_UnlinkPages(addr>>12,1);
 		}
@@ -319,6 +369,7 @@ public:
 	Bitu InitPage(Bitu lin_addr,bool writing) {
 		Bitu lin_page=lin_addr >> 12;
 		Bitu phys_page;
+		PAGING_CountInitFault();
 		if (paging.enabled) {
 			X86PageEntry table;
 			X86PageEntry entry;
@@ -396,13 +447,16 @@ public:
 				// if reading we could link the page as read-only to later cacth writes,
 				// will slow down pretty much but allows catching all dirty events
 				PAGING_LinkPage(lin_page,phys_page);
+				InitPageLinkGlobal(lin_page,entry);
 			} else {
 				if (priv_check==1) {
 					PAGING_LinkPage(lin_page,phys_page);
+					InitPageLinkGlobal(lin_page,entry);
 					return 1;
 				} else if (writing) {
 					PageHandler * handler=MEM_GetPageHandler(phys_page);
 					PAGING_LinkPage(lin_page,phys_page);
+					InitPageLinkGlobal(lin_page,entry);
 					if (!(handler->flags & PFLAG_READABLE)) return 1;
 					if (!(handler->flags & PFLAG_WRITEABLE)) return 1;
 					if (get_tlb_read(lin_addr)!=get_tlb_write(lin_addr)) return 1;
@@ -410,6 +464,7 @@ public:
 					else return 1;
 				} else {
 					PAGING_LinkPage_ReadOnly(lin_page,phys_page);
+					InitPageLinkGlobal(lin_page,entry);
 				}
 			}
 		} else {
@@ -655,9 +710,11 @@ void PAGING_InitTLB(void) {
 }
 
 void PAGING_ClearTLB(void) {
+	PAGING_CountFlush();
+	tlb_stats.global_links=0;
 	Bit32u * entries=&paging.links.entries[0];
 	for (;paging.links.used>0;paging.links.used--) {
-		Bitu page=*entries++;
+		Bitu page=*entries++ & ~PAGING_LINK_GLOBAL;
 		paging.tlb.read[page]=0;
 		paging.tlb.write[page]=0;
 		paging.tlb.readhandler[page]=&init_page_handler;
@@ -731,6 +788,104 @@ void PAGING_LinkPage_ReadOnly(Bitu lin_page,Bitu phys_page) {
 	paging.tlb.writehandler[lin_page]=&init_page_handler_userro;
 }
 
+#elif defined(USE_ASSOC_TLB)
+
+static INLINE void InitTLBEntry(tlb_entry *entry) {
+	entry->read=0;
+	entry->write=0;
+	entry->readhandler=&init_page_handler;
+	entry->writehandler=&init_page_handler;
+	entry->lin_page=TLB_INVALID;
+}
+
+void PAGING_InitTLB(void) {
+	for (Bitu i=0;i<TLB_SETS*TLB_WAYS;i++) InitTLBEntry(&paging.tlba[i]);
+	InitTLBEntry(&paging.tlb_miss);
+	paging.tlb_miss.phys_page=0;
+	memset(paging.tlb_victim,0,sizeof(paging.tlb_victim));
+	paging.links.used=0;
+}
+
+void PAGING_ClearTLB(void) {
+	PAGING_CountFlush();
+	for (Bitu i=0;i<TLB_SETS*TLB_WAYS;i++) InitTLBEntry(&paging.tlba[i]);
+}
+
+void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
+	if (pages>TLB_SETS*TLB_WAYS) {
+		// cheaper to check every entry than every page
+		for (Bitu i=0;i<TLB_SETS*TLB_WAYS;i++) {
+			if (paging.tlba[i].lin_page-lin_page<pages) InitTLBEntry(&paging.tlba[i]);
+		}
+		return;
+	}
+	for (;pages>0;pages--) {
+		tlb_entry *entry = get_tlb_entry(lin_page<<12);
+		if (entry!=&paging.tlb_miss) InitTLBEntry(entry);
+		lin_page++;
+	}
+}
+
+void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
+	if (lin_page<LINK_START) {
+		paging.firstmb[lin_page]=phys_page;
+		PAGING_UnlinkPages(lin_page,1);
+	} else {
+		PAGING_LinkPage(lin_page,phys_page);
+	}
+}
+
+// find the entry of a page in its set, or replace one in round robin order
+static tlb_entry *PAGING_GetTLBEntryForLink(Bitu lin_page) {
+	if (lin_page>=TLB_SIZE) E_Exit("Illegal page");
+	const Bitu set_index=lin_page & (TLB_SETS-1);
+	tlb_entry *set=&paging.tlba[set_index*TLB_WAYS];
+	Bitu way;
+	for (way=0;way<TLB_WAYS;way++) {
+		if (set[way].lin_page==lin_page) return &set[way];
+	}
+	for (way=0;way<TLB_WAYS;way++) {
+		if (set[way].lin_page==TLB_INVALID) break;
+	}
+	if (way==TLB_WAYS) {
+		way=paging.tlb_victim[set_index];
+		paging.tlb_victim[set_index]=(Bit8u)((way+1) & (TLB_WAYS-1));
+	}
+	set[way].lin_page=(Bit32u)lin_page;
+	return &set[way];
+}
+
+void PAGING_LinkPage(Bitu lin_page,Bitu phys_page) {
+	PageHandler * handler=MEM_GetPageHandler(phys_page);
+	Bitu lin_base=lin_page << 12;
+	if (phys_page>=TLB_SIZE) E_Exit("Illegal page");
+
+	tlb_entry *entry = PAGING_GetTLBEntryForLink(lin_page);
+	entry->phys_page=phys_page;
+	if (handler->flags & PFLAG_READABLE) entry->read=handler->GetHostReadPt(phys_page)-lin_base;
+	else entry->read=0;
+	if (handler->flags & PFLAG_WRITEABLE) entry->write=handler->GetHostWritePt(phys_page)-lin_base;
+	else entry->write=0;
+
+	entry->readhandler=handler;
+	entry->writehandler=handler;
+}
+
+void PAGING_LinkPage_ReadOnly(Bitu lin_page,Bitu phys_page) {
+	PageHandler * handler=MEM_GetPageHandler(phys_page);
+	Bitu lin_base=lin_page << 12;
+	if (phys_page>=TLB_SIZE) E_Exit("Illegal page");
+
+	tlb_entry *entry = PAGING_GetTLBEntryForLink(lin_page);
+	entry->phys_page=phys_page;
+	if (handler->flags & PFLAG_READABLE) entry->read=handler->GetHostReadPt(phys_page)-lin_base;
+	else entry->read=0;
+	entry->write=0;
+
+	entry->readhandler=handler;
+	entry->writehandler=&init_page_handler_userro;
+}
+
 #else
 
 static INLINE void InitTLBInt(tlb_entry *bank) {
@@ -754,9 +909,11 @@ void PAGING_InitTLB(void) {
 }
 
 void PAGING_ClearTLB(void) {
+	PAGING_CountFlush();
+	tlb_stats.global_links=0;
 	Bit32u * entries=&paging.links.entries[0];
 	for (;paging.links.used>0;paging.links.used--) {
-		Bitu page=*entries++;
+		Bitu page=*entries++ & ~PAGING_LINK_GLOBAL;
 		tlb_entry *entry = get_tlb_entry(page<<12);
 		entry->read=0;
 		entry->write=0;
@@ -836,6 +993,22 @@ void PAGING_LinkPage_ReadOnly(Bitu lin_page,Bitu phys_page) {
 
 #endif
 
+/* Flush everything but the pages that were linked through global page table entries */
+static void PAGING_ClearNonGlobalTLB(void) {
+#if defined(USE_ASSOC_TLB)
+	PAGING_ClearTLB();
+#else
+	PAGING_CountFlush();
+	Bitu kept=0;
+	for (Bitu i=0;i<paging.links.used;i++) {
+		Bit32u page=paging.links.entries[i];
+		if (page & PAGING_LINK_GLOBAL) paging.links.entries[kept++]=page;
+		else PAGING_UnlinkPages(page,1);
+	}
+	paging.links.used=kept;
+	tlb_stats.global_links=kept;
+#endif
+}
 
 void PAGING_SetDirBase(Bitu cr3) {
 	paging.cr3=cr3;
@@ -844,10 +1017,18 @@ void PAGING_SetDirBase(Bitu cr3) {
 	paging.base.addr=cr3 & ~4095;
 //	LOG(LOG_PAGING,LOG_NORMAL)("CR3:%X Base %X",cr3,paging.base.page);
 	if (paging.enabled) {
-		PAGING_ClearTLB();
+		if (paging.cr4 & CR4_PAGEGLOBAL) PAGING_ClearNonGlobalTLB();
+		else PAGING_ClearTLB();
 	}
 }
 
+void PAGING_SetCR4(Bitu cr4) {
+	Bitu changed=(paging.cr4^cr4) & CR4_PAGEGLOBAL;
+	paging.cr4=cr4 & CR4_PAGEGLOBAL;
+	/* Toggling PGE flushes global pages as well */
+	if (changed) PAGING_ClearTLB();
+}
+
 void PAGING_Enable(bool enabled) {
 	/* If paging is disabled, we work from a default paging table */
 	if (paging.enabled==enabled) return;
@@ -874,6 +1055,7 @@ public:
 	PAGING(Section* configuration):Module_base(configuration){
 		/* Setup default Page Directory, force it to update */
 		paging.enabled=false;
+		paging.cr4=0;
 		PAGING_InitTLB();
 		Bitu i;
 		for (i=0;i<LINK_START;i++) {
@@ -47,6 +47,7 @@ using namespace std;
 #include "programs.h"
 #include "debug_inc.h"
 #include "../cpu/lazyflags.h"
+#include "../cpu/dyn_profile.h"
 #include "keyboard.h"
 #include "setup.h"
 
@@ -1312,6 +1313,50 @@ bool ParseCommand(char* str) {
 		return true;
 	};
 
+	if (command == "DYNPROF") { //Dynamic core profile
+		while (found[0] == ' ') found++;
+		if (strncasecmp(found,"RESET",5) == 0) {
+			DYN_ProfileReset();
+			DEBUG_ShowMsg("DEBUG: Dynamic core profile cleared.\n");
+		} else {
+			Bitu count = found[0] ? (Bitu)atoi(found) : 20;
+			DYN_ProfileReport(count ? count : 20);
+		}
+		return true;
+	};
+
+#if (C_DYNREC)
+	if (command == "DYNFLAGS") { //Show dynamic core flags optimization statistics
+		Bitu queued,eliminated;
+		CPU_Core_Dynrec_GetFlagsStats(queued,eliminated);
+		DEBUG_ShowMsg("Dynamic core: %lu of %lu flag computations eliminated\n",
+		              (unsigned long)eliminated,(unsigned long)queued);
+		return true;
+	};
+#endif
+
+	if (command == "EVENTS") { //Show pic event queue statistics
+		const PIC_EventStats & stats=PIC_GetEventStats();
+		DEBUG_ShowMsg("PIC events: %llu added, %llu run, %lu/s last second\n",
+		              (unsigned long long)stats.added,(unsigned long long)stats.dispatched,
+		              (unsigned long)stats.events_per_second);
+		DEBUG_ShowMsg("PIC queue depth: %.2f average last second, %lu peak, pool of %lu\n",
+		              stats.average_depth,(unsigned long)stats.peak_depth,
+		              (unsigned long)stats.pool_size);
+		return true;
+	};
+
+	if (command == "TLB") { //Show paging tlb statistics
+		PagingTLBStats stats;
+		PAGING_GetTLBStats(stats);
+		DEBUG_ShowMsg("TLB: %lu flushes, %lu/s last second, %lu global pages kept\n",
+		              (unsigned long)stats.flushes,(unsigned long)stats.flushes_per_second,
+		              (unsigned long)stats.global_links);
+		DEBUG_ShowMsg("TLB: %lu page inits, %lu/s last second\n",
+		              (unsigned long)stats.init_faults,(unsigned long)stats.init_faults_per_second);
+		return true;
+	};
+
 
 #if C_HEAVY_DEBUG
 	if (command == "HEAVYLOG") { // Create Cpu log file
@@ -1373,6 +1418,12 @@ bool ParseCommand(char* str) {
 		DEBUG_ShowMsg("PAGING [page]             - Display content of page table.\n");
 		DEBUG_ShowMsg("EXTEND                    - Toggle additional info.\n");
 		DEBUG_ShowMsg("TIMERIRQ                  - Run the system timer.\n");
+		DEBUG_ShowMsg("EVENTS                    - Show PIC event queue statistics.\n");
+		DEBUG_ShowMsg("TLB                       - Show TLB flush and page init statistics.\n");
+		DEBUG_ShowMsg("DYNPROF [num] / RESET     - Show / clear hottest dynamic core blocks.\n");
+#if (C_DYNREC)
+		DEBUG_ShowMsg("DYNFLAGS                  - Show eliminated dynamic core flag computations.\n");
+#endif
 
 		DEBUG_ShowMsg("HELP                      - Help\n");
 		DEBUG_ShowMsg("Keys------------------------------------------------\n");
@@ -702,8 +702,11 @@ static Bitu DOS_21Handler(void) {
 		{ 
 			Bit16u toread=reg_cx;
 			dos.echo=true;
-			if (DOS_ReadFile(reg_bx,dos_copybuf,&toread)) {
-				MEM_BlockWrite(SegPhys(ds)+reg_dx,dos_copybuf,toread);
+			const PhysPt dest=SegPhys(ds)+reg_dx;
+			/* Files are read straight into guest ram when it is contiguous on the host */
+			const HostPt direct=DOS_IsDeviceHandle(reg_bx) ? nullptr : MEM_GetBlockWritePt(dest,toread);
+			if (DOS_ReadFile(reg_bx,direct ? direct : dos_copybuf,&toread)) {
+				if (!direct) MEM_BlockWrite(dest,dos_copybuf,toread);
 				reg_ax=toread;
 				CALLBACK_SCF(false);
 			} else {
@@ -717,8 +720,10 @@ static Bitu DOS_21Handler(void) {
 	case 0x40:					/* WRITE Write to file or device */
 		{
 			Bit16u towrite=reg_cx;
-			MEM_BlockRead(SegPhys(ds)+reg_dx,dos_copybuf,towrite);
-			if (DOS_WriteFile(reg_bx,dos_copybuf,&towrite)) {
+			const PhysPt src=SegPhys(ds)+reg_dx;
+			const HostPt direct=DOS_IsDeviceHandle(reg_bx) ? nullptr : MEM_GetBlockReadPt(src,towrite);
+			if (!direct) MEM_BlockRead(src,dos_copybuf,towrite);
+			if (DOS_WriteFile(reg_bx,direct ? direct : dos_copybuf,&towrite)) {
 				reg_ax=towrite;
 	   			CALLBACK_SCF(false);
 			} else {
@@ -535,6 +535,13 @@ bool DOS_WriteFile(Bit16u entry,Bit8u * data,Bit16u * amount,bool fcb) {
 	return ret;
 }
 
+/* Invalid handles are reported as devices so callers keep the copying path */
+bool DOS_IsDeviceHandle(Bit16u entry) {
+	Bit32u handle=RealHandle(entry);
+	if (handle>=DOS_FILES || !Files[handle]) return true;
+	return (Files[handle]->GetInformation() & 0x8000)!=0;
+}
+
 bool DOS_SeekFile(Bit16u entry,Bit32u * pos,Bit32u type,bool fcb) {
 	Bit32u handle = fcb?entry:RealHandle(entry);
 	if (handle>=DOS_FILES) {
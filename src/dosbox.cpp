@@ -504,10 +504,19 @@ void DOSBOX_Init(void) {
 	Pstring->Set_help("CPU Core used in emulation. auto will switch to dynamic if available and\n"
 		"appropriate.");
 
+#if (C_DYNREC)
+	Pint = secprop->Add_int("dynamic_cache",Property::Changeable::OnlyAtStart,8);
+	Pint->SetMinMax(2,64);
+	Pint->Set_help("Size of the dynamic core's code cache in megabytes. Larger values keep more\n"
+		"translated code around in big protected mode games.");
+#endif
+
 	const char* cputype_values[] = { "auto", "386", "386_slow", "486_slow", "pentium_slow", "386_prefetch", 0};
 	Pstring = secprop->Add_string("cputype",Property::Changeable::Always,"auto");
 	Pstring->Set_values(cputype_values);
-	Pstring->Set_help("CPU Type used in emulation. auto is the fastest choice.");
+	Pstring->Set_help("CPU Type used in emulation. auto is the fastest choice.\n"
+		"pentium_slow also reports global pages (PGE) through CPUID, so paged\n"
+		"operating systems can keep their kernel mappings across task switches.");
 
 
 	Pmulti_remain = secprop->Add_multiremain("cycles",Property::Changeable::Always," ");
@@ -568,6 +577,12 @@ void DOSBOX_Init(void) {
 	Pint->SetMinMax(0,100);
 	Pint->Set_help("How many milliseconds of data to keep on top of the blocksize.");
 
+	const char *resamplers[] = {"linear", "sinc8", "sinc16", "sinc32", 0};
+	Pstring = secprop->Add_string("resampling",Property::Changeable::OnlyAtStart,"linear");
+	Pstring->Set_values(resamplers);
+	Pstring->Set_help("How channels that run at a different rate than the mixer are resampled.\n"
+	                  "The sinc filters avoid aliasing, more taps give a sharper cutoff but cost more.");
+
 	secprop = control->AddSection_prop("midi", &MIDI_Init, true);
 	secprop->AddInitFunction(&MPU401_Init,true);//done
 
@@ -660,6 +675,10 @@ void DOSBOX_Init(void) {
 	Pint->Set_help("Sample rate of OPL music emulation. Use 49716 for the highest\n"
 	               "quality (set the mixer.rate accordingly).");
 
+	Pbool = secprop->Add_bool("oplthread", Property::Changeable::WhenIdle, true);
+	Pbool->Set_help("Synthesize OPL music on a separate thread when the host has more\n"
+	                "than one core. Adds two milliseconds of latency to the FM output.");
+
 	secprop=control->AddSection_prop("gus",&GUS_Init,true); //done
 	Pbool = secprop->Add_bool("gus",Property::Changeable::WhenIdle,false);
 	Pbool->Set_help("Enable the Gravis UltraSound emulation.");
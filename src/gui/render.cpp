@@ -153,6 +153,9 @@ bool RENDER_StartUpdate(void) {
 		return false;
 	if (GCC_UNLIKELY(!render.active))
 		return false;
+	/* Nothing is shown, so only generate the frame if it gets captured */
+	if (GCC_UNLIKELY(render.nodraw && !(CaptureState & (CAPTURE_IMAGE|CAPTURE_VIDEO))))
+		return false;
 	if (GCC_UNLIKELY(render.frameskip.count<render.frameskip.max)) {
 		render.frameskip.count++;
 		return false;
@@ -454,6 +457,7 @@ forcenormal:
 		GFX_SetShader(render.shader_src);
 	#endif
 	gfx_flags=GFX_SetSize(width,height,gfx_flags,gfx_scalew,gfx_scaleh,&RENDER_CallBack,par);
+	render.nodraw = (gfx_flags & GFX_NODRAW) > 0;
 	if (gfx_flags & GFX_CAN_8)
 		render.scale.outMode = scalerMode8;
 	else if (gfx_flags & GFX_CAN_15)
@@ -28,6 +28,7 @@
 #include <array>
 #include <cassert>
 #include <cstdlib>
+#include <vector>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -59,6 +60,7 @@
 #include "cpu.h"
 #include "control.h"
 #include "render.h"
+#include "dos_inc.h"
 
 #include "../libs/ppscale/ppscale.h"
 
@@ -222,6 +224,7 @@ enum MouseControlType {
 enum SCREEN_TYPES	{
 	SCREEN_SURFACE,
 	SCREEN_TEXTURE,
+	SCREEN_HEADLESS,	// no window, frames are only rendered for captures
 #if C_OPENGL
 	SCREEN_OPENGL
 #endif
@@ -333,6 +336,8 @@ struct SDL_Block {
 		SDL_Texture *texture = nullptr;
 		SDL_PixelFormat *pixelFormat = nullptr;
 	} texture;
+	bool headless = false;
+	std::vector<uint32_t> headless_frame = {};
 	struct {
 		int xsensitivity = 0;
 		int ysensitivity = 0;
@@ -580,6 +585,7 @@ check_surface:
 	case SCREEN_OPENGL:
 #endif
 	case SCREEN_TEXTURE:
+	case SCREEN_HEADLESS:
 		// We only accept 32bit output from the scalers here
 		if (!(flags&GFX_CAN_32)) goto check_surface;
 		flags|=GFX_SCALING;
@@ -1122,6 +1128,12 @@ dosurface:
 		sdl.desktop.type = SCREEN_TEXTURE;
 		break; // SCREEN_TEXTURE
 	}
+	case SCREEN_HEADLESS:
+		// Only written to while a capture is running
+		sdl.headless_frame.resize(width * height);
+		retFlags = GFX_CAN_32 | GFX_SCALING | GFX_NODRAW;
+		sdl.desktop.type = SCREEN_HEADLESS;
+		break; // SCREEN_HEADLESS
 #if C_OPENGL
 	case SCREEN_OPENGL: {
 		if (sdl.opengl.pixel_buffer_object) {
@@ -1529,6 +1541,11 @@ bool GFX_StartUpdate(uint8_t * &pixels, int &pitch)
 		pitch = sdl.texture.input_surface->pitch;
 		sdl.updating = true;
 		return true;
+	case SCREEN_HEADLESS:
+		pixels = reinterpret_cast<uint8_t *>(sdl.headless_frame.data());
+		pitch = sdl.draw.width * sizeof(uint32_t);
+		sdl.updating = true;
+		return true;
 #if C_OPENGL
 	case SCREEN_OPENGL:
 		if (sdl.opengl.pixel_buffer_object) {
@@ -1583,6 +1600,8 @@ void GFX_EndUpdate( const Bit16u *changedLines ) {
 		SDL_RenderCopy(sdl.renderer, sdl.texture.texture, NULL, &sdl.clip);
 		SDL_RenderPresent(sdl.renderer);
 		break;
+	case SCREEN_HEADLESS:
+		break;
 #if C_OPENGL
 	case SCREEN_OPENGL:
 		// Clear drawing area. Some drivers (on Linux) have more than 2 buffers and the screen might
@@ -1670,10 +1689,11 @@ Bitu GFX_GetRGB(Bit8u red,Bit8u green,Bit8u blue) {
 		return SDL_MapRGB(sdl.surface->format,red,green,blue);
 	case SCREEN_TEXTURE:
 		return SDL_MapRGB(sdl.texture.pixelFormat, red, green, blue);
+	case SCREEN_HEADLESS:
 #if C_OPENGL
 	case SCREEN_OPENGL:
-		return ((blue << 0) | (green << 8) | (red << 16)) | (255 << 24);
 #endif
+		return ((blue << 0) | (green << 8) | (red << 16)) | (255 << 24);
 	}
 	return 0;
 }
@@ -2138,6 +2158,12 @@ static void GUI_StartUp(Section * sec) {
 		sdl.desktop.want_type=SCREEN_SURFACE;//SHOULDN'T BE POSSIBLE anymore
 	}
 
+	if (sdl.headless) {
+		LOG_MSG("SDL: Running headless, output %s is not used",output.c_str());
+		sdl.desktop.want_type = SCREEN_HEADLESS;
+		sdl.scaling_mode = SmNone;
+	}
+
 	sdl.texture.texture = 0;
 	sdl.texture.pixelFormat = 0;
 	sdl.render_driver = section->Get_string("texture_renderer");
@@ -2219,20 +2245,23 @@ static void GUI_StartUp(Section * sec) {
 	} /* OPENGL is requested end */
 #endif	//OPENGL
 
-	if (!SetDefaultWindowMode())
-		E_Exit("Could not initialize video: %s", SDL_GetError());
+	// A headless run never opens a window
+	if (!sdl.headless) {
+		if (!SetDefaultWindowMode())
+			E_Exit("Could not initialize video: %s", SDL_GetError());
 
-	// FIXME the code updated sdl.desktop.bpp in here (has effect in setting up scalers)
+		// FIXME the code updated sdl.desktop.bpp in here (has effect in setting up scalers)
 
-	SDL_SetWindowTitle(sdl.window, "dosbox-staging");
-	SetIcon();
+		SDL_SetWindowTitle(sdl.window, "dosbox-staging");
+		SetIcon();
 
-	const bool tiny_fullresolution = splash_image.width > sdl.desktop.full.width ||
-	                                 splash_image.height > sdl.desktop.full.height;
-	if (!(sdl.desktop.fullscreen && tiny_fullresolution)) {
-		GFX_Start();
-		DisplaySplash(1000);
-		GFX_Stop();
+		const bool tiny_fullresolution = splash_image.width > sdl.desktop.full.width ||
+		                                 splash_image.height > sdl.desktop.full.height;
+		if (!(sdl.desktop.fullscreen && tiny_fullresolution)) {
+			GFX_Start();
+			DisplaySplash(1000);
+			GFX_Stop();
+		}
 	}
 
 	// Apply the user's mouse settings
@@ -3170,6 +3199,9 @@ int main(int argc, char* argv[]) {
 			return err;
 		}
 
+		sdl.headless = control->cmdline->FindExist("--headless") ||
+		               control->cmdline->FindExist("-headless");
+
 #if C_DEBUG
 		DEBUG_SetupConsole();
 #endif
@@ -3181,6 +3213,14 @@ int main(int argc, char* argv[]) {
 	LOG_MSG("dosbox-staging version %s", VERSION);
 	LOG_MSG("---");
 
+	if (sdl.headless) {
+		// Neither a display nor an audio device is needed, but SDL
+		// still provides the events and timers
+		constexpr int overwrite = 0; // don't overwrite
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", overwrite);
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", overwrite);
+	}
+
 	if (SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO) < 0)
 		E_Exit("Can't init SDL %s", SDL_GetError());
 	sdl.initialized = true;
@@ -3257,6 +3297,11 @@ int main(int argc, char* argv[]) {
 #if (ENVIRON_LINKED)
 		control->ParseEnv(environ);
 #endif
+		if (sdl.headless) {
+			/* Batch runs go as fast as possible without sound output */
+			control->GetSection("cpu")->HandleInputline("cycles=max");
+			control->GetSection("mixer")->HandleInputline("nosound=true");
+		}
 //		UI_Init();
 //		if (control->cmdline->FindExist("-startui")) UI_Run(false);
 		/* Init all the sections */
@@ -3264,7 +3309,7 @@ int main(int argc, char* argv[]) {
 		/* Some extra SDL Functions */
 		Section_prop * sdl_sec=static_cast<Section_prop *>(control->GetSection("sdl"));
 
-		if (control->cmdline->FindExist("-fullscreen") || sdl_sec->Get_bool("fullscreen")) {
+		if (!sdl.headless && (control->cmdline->FindExist("-fullscreen") || sdl_sec->Get_bool("fullscreen"))) {
 			if(!sdl.desktop.fullscreen) { //only switch if not already in fullscreen
 				GFX_SwitchFullScreen();
 			}
@@ -3277,6 +3322,9 @@ int main(int argc, char* argv[]) {
 
 		/* Start up main machine */
 		control->StartUp();
+		/* Report the result of the last DOS program to the caller */
+		if (sdl.headless)
+			rcode = dos.return_code;
 		/* Shutdown everything */
 	} catch (char * error) {
 		rcode = 1;
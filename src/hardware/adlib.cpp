@@ -20,6 +20,7 @@
 #include <string.h>
 #include <math.h>
 #include <sys/types.h>
+#include <algorithm>
 #include "adlib.h"
 
 #include "setup.h"
@@ -43,17 +44,17 @@ namespace OPL2 {
 		virtual void WriteReg( Bit32u reg, Bit8u val ) {
 			adlib_write(reg,val);
 		}
-		virtual Bit32u WriteAddr( Bit32u port, Bit8u val ) {
-			return val;
-		}
 
-		virtual void Generate( MixerChannel* chan, Bitu samples ) {
+		virtual void Generate( Bit32s* buffer, Bitu samples ) {
 			Bit16s buf[1024];
 			while( samples > 0 ) {
 				Bitu todo = samples > 1024 ? 1024 : samples;
 				samples -= todo;
 				adlib_getsample(buf, todo);
-				chan->AddSamples_m16( todo, buf );
+				for ( Bitu i = 0; i < todo; i++ ) {
+					*buffer++ = buf[i];
+					*buffer++ = buf[i];
+				}
 			}
 		}
 		virtual void Init( Bitu rate ) {
@@ -72,17 +73,14 @@ namespace OPL3 {
 		virtual void WriteReg( Bit32u reg, Bit8u val ) {
 			adlib_write(reg,val);
 		}
-		virtual Bit32u WriteAddr( Bit32u port, Bit8u val ) {
-			adlib_write_index(port, val);
-			return opl_index;
-		}
-		virtual void Generate( MixerChannel* chan, Bitu samples ) {
+		virtual void Generate( Bit32s* buffer, Bitu samples ) {
 			Bit16s buf[1024*2];
 			while( samples > 0 ) {
 				Bitu todo = samples > 1024 ? 1024 : samples;
 				samples -= todo;
 				adlib_getsample(buf, todo);
-				chan->AddSamples_s16( todo, buf );
+				for ( Bitu i = 0; i < todo * 2; i++ )
+					*buffer++ = buf[i];
 			}
 		}
 		virtual void Init( Bitu rate ) {
@@ -102,16 +100,16 @@ struct Handler : public Adlib::Handler {
 		ym3812_write(chip, 0, reg);
 		ym3812_write(chip, 1, val);
 	}
-	virtual Bit32u WriteAddr(Bit32u port, Bit8u val) {
-		return val;
-	}
-	virtual void Generate(MixerChannel* chan, Bitu samples) {
+	virtual void Generate(Bit32s* buffer, Bitu samples) {
 		Bit16s buf[1024 * 2];
 		while (samples > 0) {
 			Bitu todo = samples > 1024 ? 1024 : samples;
 			samples -= todo;
 			ym3812_update_one(chip, buf, todo);
-			chan->AddSamples_m16(todo, buf);
+			for (Bitu i = 0; i < todo; i++) {
+				*buffer++ = buf[i];
+				*buffer++ = buf[i];
+			}
 		}
 	}
 	virtual void Init(Bitu rate) {
@@ -134,13 +132,9 @@ struct Handler : public Adlib::Handler {
 		ymf262_write(chip, 0, reg);
 		ymf262_write(chip, 1, val);
 	}
-	virtual Bit32u WriteAddr(Bit32u port, Bit8u val) {
-		return val;
-	}
-	virtual void Generate(MixerChannel* chan, Bitu samples) {
+	virtual void Generate(Bit32s* buffer, Bitu samples) {
 		//We generate data for 4 channels, but only the first 2 are connected on a pc
 		Bit16s buf[4][1024];
-		Bit16s result[1024][2];
 		Bit16s* buffers[4] = { buf[0], buf[1], buf[2], buf[3] };
 
 		while (samples > 0) {
@@ -149,10 +143,9 @@ struct Handler : public Adlib::Handler {
 			ymf262_update_one(chip, buffers, todo);
 			//Interleave the samples before mixing
 			for (Bitu i = 0; i < todo; i++) {
-				result[i][0] = buf[0][i];
-				result[i][1] = buf[1][i];
+				*buffer++ = buf[0][i];
+				*buffer++ = buf[1][i];
 			}
-			chan->AddSamples_s16(todo, result[0]);
 		}
 	}
 	virtual void Init(Bitu rate) {
@@ -169,39 +162,26 @@ namespace NukedOPL {
 
 struct Handler : public Adlib::Handler {
 	opl3_chip chip = {};
-	Bit8u newm = 0;
 
 	void WriteReg(Bit32u reg, Bit8u val) override
 	{
 		OPL3_WriteRegBuffered(&chip, (Bit16u)reg, val);
-		if (reg == 0x105)
-			newm = reg & 0x01;
-	}
-
-	Bit32u WriteAddr(Bit32u port, Bit8u val) override
-	{
-		Bit16u addr;
-		addr = val;
-		if ((port & 2) && (addr == 0x05 || newm)) {
-			addr |= 0x100;
-		}
-		return addr;
 	}
 
-	void Generate(MixerChannel *chan, Bitu samples) override
+	void Generate(Bit32s *buffer, Bitu samples) override
 	{
 		int16_t buf[1024 * 2];
 		while (samples > 0) {
 			uint32_t todo = samples > 1024 ? 1024 : samples;
 			OPL3_GenerateStream(&chip, buf, todo);
-			chan->AddSamples_s16(todo, buf);
+			for (uint32_t i = 0; i < todo * 2; i++)
+				*buffer++ = buf[i];
 			samples -= todo;
 		}
 	}
 
 	void Init(Bitu rate) override
 	{
-		newm = 0;
 		OPL3_Reset(&chip, rate);
 	}
 };
@@ -536,6 +516,116 @@ void Module::CacheWrite( Bit32u reg, Bit8u val ) {
 	cache[ reg ] = val;
 }
 
+/*
+	The handler only sees writes when it renders the block they fall in, so
+	the register selected by an address port is decoded from the cache,
+	which is always up to date.
+*/
+Bit32u Module::DecodeAddr( Bitu port, Bit8u val ) const {
+	if ( (port & 2) && ( val == 0x05 || (cache[0x105] & 1) ) )
+		return 0x100 | val;
+	return val;
+}
+
+//Queue a write for the handler at the sample matching the current time
+void Module::HandlerWrite( Bit32u reg, Bit8u val ) {
+	double pos = ( PIC_FullIndex() - blockStart ) * rate / 1000.0;
+	QueuedWrite write = { pos > 0 ? (Bitu)pos : 0, reg, val };
+	writes.push_back( write );
+}
+
+//Render the next samples of a job, applying its writes as they come due
+void Module::Render( RenderJob& job, Bit32s* buffer, Bitu samples ) {
+	while ( samples > 0 ) {
+		while ( job.next < job.writes.size() && job.writes[job.next].pos <= job.pos ) {
+			handler->WriteReg( job.writes[job.next].reg, job.writes[job.next].val );
+			job.next++;
+		}
+		Bitu todo = samples;
+		if ( job.next < job.writes.size() && job.writes[job.next].pos - job.pos < todo )
+			todo = job.writes[job.next].pos - job.pos;
+		handler->Generate( buffer, todo );
+		buffer += todo * 2;
+		job.pos += todo;
+		samples -= todo;
+	}
+}
+
+//Writes at the very end of a job still have to reach the handler
+void Module::Finish( RenderJob& job ) {
+	for ( ; job.next < job.writes.size(); job.next++ )
+		handler->WriteReg( job.writes[job.next].reg, job.writes[job.next].val );
+}
+
+void Module::WorkerLoop() {
+	Bit32s buffer[512][2];
+	std::unique_lock<std::mutex> guard( lock );
+	for (;;) {
+		jobReady.wait( guard, [this] { return quit || !jobs.empty(); } );
+		if ( quit )
+			return;
+		RenderJob job = std::move( jobs.front() );
+		jobs.pop_front();
+		while ( job.pos < job.samples ) {
+			guard.unlock();
+			Bitu todo = job.samples - job.pos;
+			if ( todo > 512 )
+				todo = 512;
+			Render( job, buffer[0], todo );
+			guard.lock();
+			//Copy into the fifo as space frees up
+			Bitu copied = 0;
+			while ( copied < todo ) {
+				fifoChanged.wait( guard, [this] { return quit || fifoCount < OPL_FIFO_SIZE; } );
+				if ( quit )
+					return;
+				Bitu write = ( fifoRead + fifoCount ) % OPL_FIFO_SIZE;
+				Bitu count = std::min( todo - copied, std::min( OPL_FIFO_SIZE - fifoCount, OPL_FIFO_SIZE - write ) );
+				memcpy( fifo[write], buffer[copied], count * sizeof(fifo[0]) );
+				fifoCount += count;
+				copied += count;
+				fifoChanged.notify_all();
+			}
+		}
+		Finish( job );
+	}
+}
+
+void Module::Generate( Bitu samples ) {
+	RenderJob job = { samples, 0, 0, std::move( writes ) };
+	writes.clear();
+	for ( QueuedWrite& write : job.writes ) {
+		if ( write.pos > samples )
+			write.pos = samples;
+	}
+	blockStart = PIC_FullIndex();
+	if ( !threaded ) {
+		Bit32s buffer[512][2];
+		while ( job.pos < samples ) {
+			Bitu todo = std::min( samples - job.pos, (Bitu)512 );
+			Render( job, buffer[0], todo );
+			mixerChan->AddSamples_s32( todo, buffer[0] );
+		}
+		Finish( job );
+		return;
+	}
+	std::unique_lock<std::mutex> guard( lock );
+	jobs.push_back( std::move( job ) );
+	jobReady.notify_one();
+	//Take the output of earlier jobs, only waits when the thread falls behind
+	while ( samples > 0 ) {
+		fifoChanged.wait( guard, [this] { return fifoCount > 0; } );
+		Bitu count = std::min( samples, std::min( fifoCount, OPL_FIFO_SIZE - fifoRead ) );
+		guard.unlock();
+		mixerChan->AddSamples_s32( count, fifo[fifoRead] );
+		guard.lock();
+		fifoRead = ( fifoRead + count ) % OPL_FIFO_SIZE;
+		fifoCount -= count;
+		samples -= count;
+		fifoChanged.notify_all();
+	}
+}
+
 void Module::DualWrite( Bit8u index, Bit8u reg, Bit8u val ) {
 	//Make sure you don't use opl3 features
 	//Don't allow write to disable opl3		
@@ -555,7 +645,7 @@ void Module::DualWrite( Bit8u index, Bit8u reg, Bit8u val ) {
 		val |= index ? 0xA0 : 0x50;
 	}
 	Bit32u fullReg = reg + (index ? 0x100 : 0);
-	handler->WriteReg( fullReg, val );
+	HandlerWrite( fullReg, val );
 	CacheWrite( fullReg, val );
 }
 
@@ -596,6 +686,8 @@ void Module::PortWrite( Bitu port, Bitu val, Bitu iolen ) {
 	//Maybe only enable with a keyon?
 	if (!mixerChan->is_enabled) {
 		mixerChan->Enable(true);
+		//The mixer picks up from the start of this tick
+		blockStart = PIC_Ticks;
 	}
 	if ( port&1 ) {
 		switch ( mode ) {
@@ -610,7 +702,7 @@ void Module::PortWrite( Bitu port, Bitu val, Bitu iolen ) {
 		case MODE_OPL2:
 		case MODE_OPL3:
 			if ( !chip[0].Write( reg.normal, val ) ) {
-				handler->WriteReg( reg.normal, val );
+				HandlerWrite( reg.normal, val );
 				CacheWrite( reg.normal, val );
 			}
 			break;
@@ -631,7 +723,7 @@ void Module::PortWrite( Bitu port, Bitu val, Bitu iolen ) {
 		//Make sure to clip them in the right range
 		switch ( mode ) {
 		case MODE_OPL2:
-			reg.normal = handler->WriteAddr( port, val ) & 0xff;
+			reg.normal = DecodeAddr( port, val ) & 0xff;
 			break;
 		case MODE_OPL3GOLD:
 			if ( port == 0x38a ) {
@@ -648,7 +740,7 @@ void Module::PortWrite( Bitu port, Bitu val, Bitu iolen ) {
 			}
 			//Fall-through if not handled by control chip
 		case MODE_OPL3:
-			reg.normal = handler->WriteAddr( port, val ) & 0x1ff;
+			reg.normal = DecodeAddr( port, val ) & 0x1ff;
 			break;
 		case MODE_DUALOPL2:
 			//Not a 0x?88 port, when write to a specific side
@@ -712,7 +804,7 @@ void Module::Init( Mode m ) {
 		break;
 	case MODE_DUALOPL2:
 		//Setup opl3 mode in the hander
-		handler->WriteReg( 0x105, 1 );
+		HandlerWrite( 0x105, 1 );
 		//Also set it up in the cache so the capturing will start opl3
 		CacheWrite( 0x105, 1 );
 		break;
@@ -726,8 +818,8 @@ void Module::Init( Mode m ) {
 static Adlib::Module* module = 0;
 
 static void OPL_CallBack(Bitu len) {
-	module->handler->Generate( module->mixerChan, len );
-	//Disable the sound generation after 30 seconds of silence
+	module->Generate( len );
+	//Emulators which never reach digital silence stop after 30 seconds without writes
 	if ((PIC_Ticks - module->lastUsed) > 30000) {
 		Bitu i;
 		for (i=0xb0;i<0xb9;i++) if (module->cache[i]&0x20||module->cache[i+0x100]&0x20) break;
@@ -736,6 +828,14 @@ static void OPL_CallBack(Bitu len) {
 	}
 }
 
+//Nothing can become audible again without a write while no key is on
+static bool OPL_Idle(void) {
+	for (Bitu i=0xb0;i<0xb9;i++) if (module->cache[i]&0x20||module->cache[i+0x100]&0x20) return false;
+	//Percussion keys held in rhythm mode
+	if ((module->cache[0xbd]&0x20) && (module->cache[0xbd]&0x1f)) return false;
+	return true;
+}
+
 static Bitu OPL_Read(Bitu port,Bitu iolen) {
 	return module->PortRead( port, iolen );
 }
@@ -834,6 +934,12 @@ Module::Module(Section *configuration)
 	  mode(MODE_OPL2), // TODO this is set in Init and there's no good default
 	  reg{0}, // union
 	  ctrl{false, 0, 0xff, 0xff},
+	  blockStart(0.0),
+	  rate(0),
+	  threaded(false),
+	  quit(false),
+	  fifoRead(0),
+	  fifoCount(0),
 	  mixerChan(nullptr),
 	  lastUsed(0),
 	  handler(nullptr),
@@ -841,15 +947,17 @@ Module::Module(Section *configuration)
 {
 	Section_prop * section=static_cast<Section_prop *>(configuration);
 	Bitu base = section->Get_hex("sbbase");
-	Bitu rate = section->Get_int("oplrate");
+	rate = section->Get_int("oplrate");
 	//Make sure we can't select lower than 8000 to prevent fixed point issues
 	if ( rate < 8000 )
 		rate = 8000;
 	ctrl.mixer = section->Get_bool("sbmixer");
+	memset( cache, 0, sizeof(cache) );
 
 	mixerChan = mixerObject.Install(OPL_CallBack,rate,"FM");
 	//Used to be 2.0, which was measured to be too high. Exact value depends on card/clone.
 	mixerChan->SetScale( 1.5f );  
+	mixerChan->SetSleep( 1000, OPL_Idle );
 
 	handler = make_opl_handler(section->Get_string("oplemu"), oplmode);
 	handler->Init(rate);
@@ -873,6 +981,14 @@ Module::Module(Section *configuration)
 	case OPL_none:
 		break;
 	}
+	//Render on a thread of its own when the host has a core to spare
+	threaded = section->Get_bool("oplthread") && std::thread::hardware_concurrency() > 1;
+	if ( threaded ) {
+		//Start out a couple of milliseconds ahead of the mixer
+		memset( fifo, 0, sizeof(fifo) );
+		fifoCount = rate / 500;
+		worker = std::thread( &Module::WorkerLoop, this );
+	}
 	//0x388 range
 	WriteHandler[0].Install(0x388,OPL_Write,IO_MB, 4 );
 	ReadHandler[0].Install(0x388,OPL_Read,IO_MB, 4 );
@@ -889,6 +1005,15 @@ Module::Module(Section *configuration)
 }
 
 Module::~Module() {
+	if ( threaded ) {
+		{
+			std::lock_guard<std::mutex> guard( lock );
+			quit = true;
+		}
+		jobReady.notify_one();
+		fifoChanged.notify_all();
+		worker.join();
+	}
 	if ( capture ) {
 		delete capture;
 	}
@@ -28,6 +28,11 @@
 #include "hardware.h"
 
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace Adlib {
 
@@ -125,12 +130,10 @@ typedef enum {
 
 class Handler {
 public:
-	//Write an address to a chip, returns the address the chip sets
-	virtual Bit32u WriteAddr( Bit32u port, Bit8u val ) = 0;
 	//Write to a specific register in the chip
 	virtual void WriteReg( Bit32u addr, Bit8u val ) = 0;
-	//Generate a certain amount of samples
-	virtual void Generate( MixerChannel* chan, Bitu samples ) = 0;
+	//Generate a certain amount of interleaved stereo samples
+	virtual void Generate( Bit32s* buffer, Bitu samples ) = 0;
 	//Initialize at a specific sample rate and mode
 	virtual void Init( Bitu rate ) = 0;
 	virtual ~Handler() = default;
@@ -142,6 +145,24 @@ typedef Bit8u RegisterCache[512];
 //Internal class used for dro capturing
 class Capture;
 
+//Register write to apply once the handler reaches a sample in its block
+struct QueuedWrite {
+	Bitu pos;
+	Bit32u reg;
+	Bit8u val;
+};
+
+//Block of samples for the handler along with the writes inside it
+struct RenderJob {
+	Bitu samples;
+	Bitu pos;
+	Bitu next;
+	std::vector<QueuedWrite> writes;
+};
+
+//Stereo frames kept between the synthesis thread and the mixer
+#define OPL_FIFO_SIZE 4096
+
 class Module: public Module_base {
 	IO_ReadHandleObject ReadHandler[3];
 	IO_WriteHandleObject WriteHandler[3];
@@ -161,10 +182,31 @@ class Module: public Module_base {
 		Bit8u rvol;
 		bool mixer;
 	} ctrl;
+	//Handler writes waiting for the next block and the time it started at
+	std::vector<QueuedWrite> writes;
+	double blockStart;
+	Bitu rate;
+	//Synthesis thread rendering the queued jobs into the fifo
+	bool threaded;
+	bool quit;
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable jobReady;
+	std::condition_variable fifoChanged;
+	std::deque<RenderJob> jobs;
+	Bit32s fifo[OPL_FIFO_SIZE][2];
+	Bitu fifoRead;
+	Bitu fifoCount;
+
 	void CacheWrite( Bit32u reg, Bit8u val );
 	void DualWrite( Bit8u index, Bit8u reg, Bit8u val );
 	void CtrlWrite( Bit8u val );
 	Bitu CtrlRead( void );
+	Bit32u DecodeAddr( Bitu port, Bit8u val ) const;
+	void HandlerWrite( Bit32u reg, Bit8u val );
+	void Render( RenderJob& job, Bit32s* buffer, Bitu samples );
+	void Finish( RenderJob& job );
+	void WorkerLoop();
 public:
 	static OPL_Mode oplmode;
 	MixerChannel* mixerChan;
@@ -178,6 +220,8 @@ public:
 	//Handle port writes
 	void PortWrite( Bitu port, Bitu val, Bitu iolen );
 	Bitu PortRead( Bitu port, Bitu iolen );
+	//Hand the mixer the samples it asked for
+	void Generate( Bitu samples );
 	void Init( Mode m );
 
 	Module(Section *configuration);
@@ -1507,24 +1507,20 @@ void InitTables( void ) {
 #endif
 }
 
-Bit32u Handler::WriteAddr( Bit32u port, Bit8u val ) {
-	return chip.WriteAddr( port, val );
-
-}
 void Handler::WriteReg( Bit32u addr, Bit8u val ) {
 	chip.WriteReg( addr, val );
 }
 
-void Handler::Generate( MixerChannel* chan, Bitu samples ) {
-	Bit32s buffer[ 512 * 2 ];
-	if ( GCC_UNLIKELY(samples > 512) )
-		samples = 512;
-	if ( !chip.opl3Active ) {
-		chip.GenerateBlock2( samples, buffer );
-		chan->AddSamples_m32( samples, buffer );
-	} else {
+void Handler::Generate( Bit32s* buffer, Bitu samples ) {
+	if ( chip.opl3Active ) {
 		chip.GenerateBlock3( samples, buffer );
-		chan->AddSamples_s32( samples, buffer );
+		return;
+	}
+	//Expand the mono samples in place, starting from the end
+	chip.GenerateBlock2( samples, buffer );
+	for ( Bitu i = samples; i-- > 0; ) {
+		buffer[i * 2 + 0] = buffer[i];
+		buffer[i * 2 + 1] = buffer[i];
 	}
 }
 
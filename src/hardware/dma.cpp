@@ -41,6 +41,21 @@ static void UpdateEMSMapping(void) {
 	}
 }
 
+/* physical page a dma page ends up at, cares for EMS pageframe etc. */
+static INLINE Bitu DMA_MapPage(Bitu page) {
+	if (page < EMM_PAGEFRAME4K) return paging.firstmb[page];
+	if (page < EMM_PAGEFRAME4K+0x10) return ems_board_mapping[page];
+	if (page < LINK_START) return paging.firstmb[page];
+	return page;
+}
+
+/* host memory behind a physical page, 0 when its handler has none */
+static INLINE HostPt DMA_HostPage(Bitu page) {
+	PageHandler * handler = MEM_GetPageHandler(page);
+	if (!(handler->flags & PFLAG_READABLE)) return 0;
+	return handler->GetHostReadPt(page);
+}
+
 /* read a block from physical memory */
 static void DMA_BlockRead(PhysPt spage,PhysPt offset,void * data,Bitu size,Bit8u dma16) {
 	Bit8u * write=(Bit8u *) data;
@@ -53,11 +68,7 @@ static void DMA_BlockRead(PhysPt spage,PhysPt offset,void * data,Bitu size,Bit8u
 			LOG_MSG("DMA segbound wrapping (read): %x:%x size %" sBitfs(x) " [%x] wrap %x",spage,offset,size,dma16,dma_wrapping);
 		}
 		offset &= dma_wrap;
-		Bitu page = highpart_addr_page+(offset >> 12);
-		/* care for EMS pageframe etc. */
-		if (page < EMM_PAGEFRAME4K) page = paging.firstmb[page];
-		else if (page < EMM_PAGEFRAME4K+0x10) page = ems_board_mapping[page];
-		else if (page < LINK_START) page = paging.firstmb[page];
+		Bitu page = DMA_MapPage(highpart_addr_page+(offset >> 12));
 		*write++=phys_readb(page*4096 + (offset & 4095));
 	}
 }
@@ -74,11 +85,7 @@ static void DMA_BlockWrite(PhysPt spage,PhysPt offset,void * data,Bitu size,Bit8
 			LOG_MSG("DMA segbound wrapping (write): %x:%x size %" sBitfs(x) " [%x] wrap %x",spage,offset,size,dma16,dma_wrapping);
 		}
 		offset &= dma_wrap;
-		Bitu page = highpart_addr_page+(offset >> 12);
-		/* care for EMS pageframe etc. */
-		if (page < EMM_PAGEFRAME4K) page = paging.firstmb[page];
-		else if (page < EMM_PAGEFRAME4K+0x10) page = ems_board_mapping[page];
-		else if (page < LINK_START) page = paging.firstmb[page];
+		Bitu page = DMA_MapPage(highpart_addr_page+(offset >> 12));
 		phys_writeb(page*4096 + (offset & 4095), *read++);
 	}
 }
@@ -314,6 +321,39 @@ again:
 	return done;
 }
 
+/* Point data straight at the next part of the transfer in guest memory,
+ * as far as it is in one piece on the host. Stops short of the terminal
+ * count, so Read still gets to raise that and its events. Returns the
+ * amount of units taken, always a multiple of granule. */
+Bitu DmaChannel::ReadDirect(Bitu want, Bit8u * & data, Bitu granule) {
+	curraddr &= dma_wrapping;
+	if (want > currcnt) want = currcnt;
+	PhysPt offset = curraddr << DMA16;
+	const Bitu window = 0x10000 << DMA16;
+	if (offset >= window) return 0;
+	//Don't cross the point where the address wraps
+	Bitu bytes = want << DMA16;
+	if (bytes > window - offset) bytes = window - offset;
+	//Follow the pages as long as their handlers give plain host memory
+	//that follows on from the previous page
+	const Bitu page = (pagebase >> 12) + (offset >> 12);
+	const HostPt host = DMA_HostPage(DMA_MapPage(page));
+	if (!host) return 0;
+	Bitu run = 4096 - (offset & 4095);
+	for (Bitu pages = 1; run < bytes; pages++) {
+		if (DMA_HostPage(DMA_MapPage(page + pages)) != host + pages * 4096) break;
+		run += 4096;
+	}
+	if (bytes > run) bytes = run;
+	Bitu units = bytes >> DMA16;
+	units -= units % granule;
+	if (!units) return 0;
+	data = host + (offset & 4095);
+	curraddr += units;
+	currcnt -= units;
+	return units;
+}
+
 Bitu DmaChannel::Write(Bitu want, Bit8u * buffer) {
 	Bitu done=0;
 	curraddr &= dma_wrapping;
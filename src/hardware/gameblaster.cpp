@@ -143,6 +143,7 @@ public:
 
 		/* Register the Mixer CallBack */
 		cms_chan = MixerChan.Install(CMS_CallBack,sampleRate,"CMS");
+		cms_chan->SetSleep(1000);
 
 		lastWriteTicks = PIC_Ticks;
 
@@ -18,6 +18,7 @@
 
 
 #include <string.h>
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include "dosbox.h"
@@ -161,9 +162,10 @@ public:
 
 	// Returns a single 16-bit sample from the Gravis's RAM
 
-	INLINE Bit32s GetSample8() const {
-		Bit32u useAddr = WaveAddr >> WAVE_FRACT;
-		if (WaveAdd >= (1 << WAVE_FRACT)) {
+	template <bool interpolate>
+	static INLINE Bit32s GetSample8(Bit32u Addr) {
+		Bit32u useAddr = Addr >> WAVE_FRACT;
+		if (!interpolate) {
 			Bit32s tmpsmall = (Bit8s)GUSRam[useAddr];
 			return tmpsmall << 8;
 		}
@@ -173,19 +175,20 @@ public:
 			Bit32s w1 = ((Bit8s)GUSRam[useAddr]) << 8;
 			Bit32s w2 = ((Bit8s)GUSRam[nextAddr]) << 8;
 			Bit32s diff = w2 - w1;
-			Bit32s scale = (Bit32s)(WaveAddr&WAVE_FRACT_MASK);
+			Bit32s scale = (Bit32s)(Addr&WAVE_FRACT_MASK);
 			return (w1 + ((diff*scale) >> WAVE_FRACT));
 		}
 	}
 
-	INLINE Bit32s GetSample16() const {
-		Bit32u useAddr = WaveAddr >> WAVE_FRACT;
+	template <bool interpolate>
+	static INLINE Bit32s GetSample16(Bit32u Addr) {
+		Bit32u useAddr = Addr >> WAVE_FRACT;
 		// Formula used to convert addresses for use with 16-bit samples
 		Bit32u holdAddr = useAddr & 0xc0000L;
 		useAddr = useAddr & 0x1ffffL;
 		useAddr = useAddr << 1;
 		useAddr = (holdAddr | useAddr);
-		if (WaveAdd >= (1 << WAVE_FRACT)) {
+		if (!interpolate) {
 			return (GUSRam[useAddr + 0] | (((Bit8s)GUSRam[useAddr + 1]) << 8));
 		}
 		else {
@@ -193,11 +196,18 @@ public:
 			Bit32s w1 = (GUSRam[useAddr + 0] | (((Bit8s)GUSRam[useAddr + 1]) << 8));
 			Bit32s w2 = (GUSRam[useAddr + 2] | (((Bit8s)GUSRam[useAddr + 3]) << 8));
 			Bit32s diff = w2 - w1;
-			Bit32s scale = (Bit32s)(WaveAddr&WAVE_FRACT_MASK);
+			Bit32s scale = (Bit32s)(Addr&WAVE_FRACT_MASK);
 			return (w1 + ((diff*scale) >> WAVE_FRACT));
 		}
 	}
 
+	INLINE Bit32s GetSample() const {
+		const bool interpolate = WaveAdd < (1 << WAVE_FRACT);
+		if (WaveCtrl & WCTRL_16BIT)
+			return interpolate ? GetSample16<true>(WaveAddr) : GetSample16<false>(WaveAddr);
+		return interpolate ? GetSample8<true>(WaveAddr) : GetSample8<false>(WaveAddr);
+	}
+
 	void WriteWaveFreq(Bit16u val) {
 		WaveFreq = val;
 		double frameadd = double(val >> 1)/512.0;		//Samples / original gus frame
@@ -320,31 +330,92 @@ public:
 		UpdateVolumes();
 	}
 
+	// Amount of updates before the wave reaches a boundary, at most len
+	INLINE Bit32u WaveRun(Bit32u len) const {
+		if (WaveCtrl & ( WCTRL_STOP | WCTRL_STOPPED)) return len;
+		Bit64s left = (WaveCtrl & WCTRL_DECREASING) ? (Bit64s)WaveAddr - WaveStart : (Bit64s)WaveEnd - WaveAddr;
+		if (left <= 0) return 0;
+		if (!WaveAdd) return len;
+		Bit64s steps = (left - 1) / WaveAdd;
+		return steps < len ? (Bit32u)steps : len;
+	}
+	// Amount of updates before the volume ramp reaches a boundary, at most len
+	INLINE Bit32u RampRun(Bit32u len) const {
+		if (RampCtrl & 0x3) return len;
+		Bit64s left = (RampCtrl & 0x40) ? (Bit64s)RampVol - RampStart : (Bit64s)RampEnd - RampVol;
+		if (left <= 0) return 0;
+		if (!RampAdd) return len;
+		Bit64s steps = (left - 1) / RampAdd;
+		return steps < len ? (Bit32u)steps : len;
+	}
+
+	// Render a run of samples which doesn't cross a boundary, so the
+	// addresses and volume just step along
+	template <bool is16bit, bool interpolate, bool ramping>
+	void RenderRun(Bit32s * stream,Bit32u len) {
+		Bit32u addr = WaveAddr;
+		Bit32u add = 0;
+		if (!(WaveCtrl & ( WCTRL_STOP | WCTRL_STOPPED)))
+			add = (WaveCtrl & WCTRL_DECREASING) ? 0u - WaveAdd : WaveAdd;
+		Bit32u vol = RampVol;
+		Bit32u volAdd = (RampCtrl & 0x40) ? 0u - RampAdd : RampAdd;
+		Bit32s left = VolLeft;
+		Bit32s right = VolRight;
+		for (Bit32u i = 0; i < len; i++) {
+			Bit32s tmpsamp = is16bit ? GetSample16<interpolate>(addr) : GetSample8<interpolate>(addr);
+			stream[i << 1] += tmpsamp * left;
+			stream[(i << 1) + 1] += tmpsamp * right;
+			addr += add;
+			if (ramping) {
+				vol += volAdd;
+				Bit32s templeft = vol - PanLeft;
+				templeft &= ~(templeft >> 31);
+				Bit32s tempright = vol - PanRight;
+				tempright &= ~(tempright >> 31);
+				left = vol16bit[templeft >> RAMP_FRACT];
+				right = vol16bit[tempright >> RAMP_FRACT];
+			}
+		}
+		WaveAddr = addr;
+		if (ramping) {
+			RampVol = vol;
+			VolLeft = left;
+			VolRight = right;
+		}
+	}
+
+	template <bool is16bit, bool interpolate>
+	INLINE void RenderRun(Bit32s * stream,Bit32u len) {
+		if (RampCtrl & 0x3) RenderRun<is16bit, interpolate, false>(stream, len);
+		else RenderRun<is16bit, interpolate, true>(stream, len);
+	}
+
 	void generateSamples(Bit32s * stream,Bit32u len) {
 		//Disabled channel
 		if (RampCtrl & WaveCtrl & 3) return;
 
-		if (WaveCtrl & WCTRL_16BIT) {
-			for (int i = 0; i < (int)len; i++) {
-				// Get sample
-				Bit32s tmpsamp = GetSample16();
-				// Output stereo sample
-				stream[i << 1] += tmpsamp * VolLeft;
-				stream[(i << 1) + 1] += tmpsamp * VolRight;
+		Bit32u done = 0;
+		while (done < len) {
+			Bit32u run = std::min(WaveRun(len - done), RampRun(len - done));
+			//A boundary is due, take it one sample at a time
+			if (!run) {
+				Bit32s tmpsamp = GetSample();
+				stream[done << 1] += tmpsamp * VolLeft;
+				stream[(done << 1) + 1] += tmpsamp * VolRight;
 				WaveUpdate();
 				RampUpdate();
+				done++;
+				continue;
 			}
-		}
-		else {
-			for (int i = 0; i < (int)len; i++) {
-				// Get sample
-				Bit32s tmpsamp = GetSample8();
-				// Output stereo sample
-				stream[i << 1] += tmpsamp * VolLeft;
-				stream[(i << 1) + 1] += tmpsamp * VolRight;
-				WaveUpdate();
-				RampUpdate();
+			const bool interpolate = WaveAdd < (1 << WAVE_FRACT);
+			if (WaveCtrl & WCTRL_16BIT) {
+				if (interpolate) RenderRun<true, true>(stream + (done << 1), run);
+				else RenderRun<true, false>(stream + (done << 1), run);
+			} else {
+				if (interpolate) RenderRun<false, true>(stream + (done << 1), run);
+				else RenderRun<false, false>(stream + (done << 1), run);
 			}
+			done += run;
 		}
 	}
 };
@@ -482,6 +553,8 @@ static void GUS_TimerEvent(Bitu val) {
  
 static void ExecuteGlobRegister(void) {
 	int i;
+	//Wake the channel up again once it went to sleep
+	if (myGUS.ActiveChannels && !gus_chan->is_enabled) gus_chan->Enable(true);
 //	if (myGUS.gRegSelect|1!=0x44) LOG_MSG("write global register %x with %x", myGUS.gRegSelect, myGUS.gRegData);
 	switch(myGUS.gRegSelect) {
 	case 0x0:  // Channel voice control register
@@ -793,6 +866,14 @@ static void GUS_CallBack(Bitu len) {
 	CheckVoiceIrq();
 }
 
+// No voice will make sound or raise an irq before the next register write
+static bool GUS_Idle(void) {
+	for (Bitu i = 0; i < myGUS.ActiveChannels; i++) {
+		if (!(guschan[i]->RampCtrl & guschan[i]->WaveCtrl & 3)) return false;
+	}
+	return true;
+}
+
 // Generate logarithmic to linear volume conversion tables
 static void MakeTables(void) {
 	int i;
@@ -876,6 +957,7 @@ public:
 		}
 		// Register the Mixer CallBack 
 		gus_chan=MixerChan.Install(GUS_CallBack,GUS_RATE,"GUS");
+		gus_chan->SetSleep(1000, GUS_Idle);
 		myGUS.gRegData=0x1;
 		GUSReset();
 		myGUS.gRegData=0x0;
@@ -173,21 +173,157 @@ void mem_strcpy(PhysPt dest,PhysPt src) {
 	mem_writeb_inline(dest,0);
 }
 
+/* Number of bytes from address up to the end of its page, limited to size */
+static INLINE Bitu mem_page_chunk(PhysPt address,Bitu size) {
+	const Bitu left=MEM_PAGE_SIZE-(address & (MEM_PAGE_SIZE-1));
+	return (size<left) ? size : left;
+}
+
+/*
+	The block functions below work a page at a time. Each page is resolved
+	once through the TLB and, when it is backed by host memory, copied with a
+	host memcpy. Pages without a host pointer (VGA, MMIO, ROM for writes and
+	pages that still need to be initialized or faulted in) take the handler
+	path a byte at a time; the TLB is checked again after every byte, so the
+	remainder of a page switches to the fast path once it has been mapped.
+*/
+
 void mem_memcpy(PhysPt dest,PhysPt src,Bitu size) {
-	while (size--) mem_writeb_inline(dest++,mem_readb_inline(src++));
+	while (size) {
+		const Bitu chunk=mem_page_chunk(dest,mem_page_chunk(src,size));
+		const HostPt tlb_read=get_tlb_read(src);
+		const HostPt tlb_write=get_tlb_write(dest);
+		if (tlb_read && tlb_write) {
+			Bit8u const * read=tlb_read+src;
+			Bit8u * write=tlb_write+dest;
+			if (write>read && write<read+chunk) {
+				/* Keep the forward byte copy semantics for overlapping ranges */
+				for (Bitu i=0;i<chunk;i++) write[i]=read[i];
+			} else memmove(write,read,chunk);
+			dest+=chunk;src+=chunk;size-=chunk;
+		} else {
+			mem_writeb_inline(dest++,mem_readb_inline(src++));
+			size--;
+		}
+	}
 }
 
 void MEM_BlockRead(PhysPt pt,void * data,Bitu size) {
 	Bit8u * write=reinterpret_cast<Bit8u *>(data);
-	while (size--) {
-		*write++=mem_readb_inline(pt++);
+	while (size) {
+		const Bitu chunk=mem_page_chunk(pt,size);
+		const HostPt tlb_addr=get_tlb_read(pt);
+		if (tlb_addr) {
+			memcpy(write,tlb_addr+pt,chunk);
+			write+=chunk;pt+=chunk;size-=chunk;
+		} else {
+			*write++=mem_readb_inline(pt++);
+			size--;
+		}
 	}
 }
 
 void MEM_BlockWrite(PhysPt pt,void const * const data,Bitu size) {
 	Bit8u const * read = reinterpret_cast<Bit8u const * const>(data);
-	while (size--) {
-		mem_writeb_inline(pt++,*read++);
+	while (size) {
+		const Bitu chunk=mem_page_chunk(pt,size);
+		const HostPt tlb_addr=get_tlb_write(pt);
+		if (tlb_addr) {
+			memcpy(tlb_addr+pt,read,chunk);
+			read+=chunk;pt+=chunk;size-=chunk;
+		} else {
+			mem_writeb_inline(pt++,*read++);
+			size--;
+		}
+	}
+}
+
+/*
+	A block is contiguous in host memory when every page it touches has a
+	host pointer in the TLB with the same offset as the first one. Pages
+	that are not mapped yet, hold dynamic code or belong to a device make
+	the caller fall back to the block copy functions above.
+*/
+static HostPt mem_block_hostpt(PhysPt pt,Bitu size,bool write) {
+	if (!size || ((Bitu)pt+size-1)>0xffffffff) return nullptr;
+	const HostPt tlb_addr=write ? get_tlb_write(pt) : get_tlb_read(pt);
+	if (!tlb_addr) return nullptr;
+	const Bitu last=(Bitu)pt+size-1;
+	for (Bitu page=(pt|(MEM_PAGE_SIZE-1))+1;page<=last;page+=MEM_PAGE_SIZE) {
+		const PhysPt address=(PhysPt)page;
+		if ((write ? get_tlb_write(address) : get_tlb_read(address))!=tlb_addr) return nullptr;
+	}
+	return tlb_addr+pt;
+}
+
+HostPt MEM_GetBlockReadPt(PhysPt pt,Bitu size) {
+	return mem_block_hostpt(pt,size,false);
+}
+
+HostPt MEM_GetBlockWritePt(PhysPt pt,Bitu size) {
+	return mem_block_hostpt(pt,size,true);
+}
+
+/* Number of elements up to the end of the page or the wrap of the index, at least 1 */
+static INLINE Bitu mem_string_chunk(PhysPt base,Bitu index,Bitu mask,Bitu size,Bitu count) {
+	Bitu bytes=MEM_PAGE_SIZE-((base+index) & (MEM_PAGE_SIZE-1));
+	const Bitu wrap=mask-index;
+	if (wrap<bytes) bytes=wrap+1;
+	bytes/=size;
+	if (!bytes) return 1;	// element crosses the page or wraps
+	return (bytes<count) ? bytes : count;
+}
+
+void MEM_StringMove(PhysPt si_base,Bitu & si_index,PhysPt di_base,Bitu & di_index,Bitu mask,Bitu count,Bitu size) {
+	while (count) {
+		Bitu todo=mem_string_chunk(si_base,si_index,mask,size,count);
+		todo=mem_string_chunk(di_base,di_index,mask,size,todo);
+		count-=todo;
+		const Bitu bytes=todo*size;
+		HostPt read=MEM_GetBlockReadPt(si_base+si_index,bytes);
+		HostPt write=read ? MEM_GetBlockWritePt(di_base+di_index,bytes) : nullptr;
+		/* A destination just behind the source repeats elements, keep that for the slow path */
+		if (write && !(write>read && write<read+bytes)) {
+			memmove(write,read,bytes);
+			si_index=(si_index+bytes) & mask;
+			di_index=(di_index+bytes) & mask;
+			continue;
+		}
+		for (;todo>0;todo--) {
+			switch (size) {
+			case 1:mem_writeb_inline(di_base+di_index,mem_readb_inline(si_base+si_index));break;
+			case 2:mem_writew_inline(di_base+di_index,mem_readw_inline(si_base+si_index));break;
+			default:mem_writed_inline(di_base+di_index,mem_readd_inline(si_base+si_index));break;
+			}
+			si_index=(si_index+size) & mask;
+			di_index=(di_index+size) & mask;
+		}
+	}
+}
+
+void MEM_StringStore(PhysPt di_base,Bitu & di_index,Bitu mask,Bitu count,Bitu size,Bit32u val) {
+	while (count) {
+		Bitu todo=mem_string_chunk(di_base,di_index,mask,size,count);
+		count-=todo;
+		const Bitu bytes=todo*size;
+		HostPt write=MEM_GetBlockWritePt(di_base+di_index,bytes);
+		if (write) {
+			switch (size) {
+			case 1:memset(write,(Bit8u)val,bytes);break;
+			case 2:for (Bitu i=0;i<bytes;i+=2) host_writew(write+i,(Bit16u)val);break;
+			default:for (Bitu i=0;i<bytes;i+=4) host_writed(write+i,val);break;
+			}
+			di_index=(di_index+bytes) & mask;
+			continue;
+		}
+		for (;todo>0;todo--) {
+			switch (size) {
+			case 1:mem_writeb_inline(di_base+di_index,(Bit8u)val);break;
+			case 2:mem_writew_inline(di_base+di_index,(Bit16u)val);break;
+			default:mem_writed_inline(di_base+di_index,val);break;
+			}
+			di_index=(di_index+size) & mask;
+		}
 	}
 }
 
@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <math.h>
 #include <algorithm>
+#include <atomic>
 
 #if defined (WIN32)
 //Midi listing
@@ -68,6 +69,11 @@
 #define TICK_NEXT ( 1 << TICK_SHIFT)
 #define TICK_MASK (TICK_NEXT -1)
 
+//Sinc filter phases and fixed point scale of its coefficients
+#define FIR_PHASE_BITS 7
+#define FIR_PHASE_SHIFT (FREQ_SHIFT - FIR_PHASE_BITS)
+#define FIR_SHIFT 15
+
 
 static INLINE Bit16s MIXER_CLIP(Bits SAMP) {
 	if (SAMP < MAX_AUDIO) {
@@ -90,8 +96,19 @@ static struct {
 	bool nosound;
 	Bit32u freq;
 	Bit32u blocksize;
+	Bitu fir_taps;		//0 selects linear interpolation
 	//Note: As stated earlier, all sdl code shall rather be in sdlmain
 	SDL_AudioDeviceID sdldevice;
+	/* Finished frames on their way to the audio device. Only MIXER_Mix
+	 * writes and only the callback reads, so neither side takes a lock. */
+	struct {
+		int16_t frames[MIXER_BUFSIZE][2];
+		std::atomic<Bitu> write,read;		// free running frame counters
+		std::atomic<Bitu> left;				// frames queued after the last callback
+		std::atomic<Bitu> left_min,left_max;
+		std::atomic<Bitu> underruns;		// callbacks that ran out of frames
+		std::atomic<Bitu> dropped;			// frames thrown away on overflow
+	} ring;
 } mixer;
 
 Bit8u MixTemp[MIXER_BUFSIZE];
@@ -136,16 +153,6 @@ void MIXER_DelChannel(MixerChannel* delchan) {
 	}
 }
 
-static void MIXER_LockAudioDevice()
-{
-	SDL_LockAudioDevice(mixer.sdldevice);
-}
-
-static void MIXER_UnlockAudioDevice()
-{
-	SDL_UnlockAudioDevice(mixer.sdldevice);
-}
-
 void MixerChannel::UpdateVolume()
 {
 	volmul[0]=(Bits)((1 << MIXER_VOLSHIFT)*scale[0]*volmain[0]*mixer.mastervol[0]);
@@ -204,15 +211,13 @@ void MixerChannel::Enable(const bool should_enable)
 	if (is_enabled == should_enable)
 		return;
 
-	// Lock the channel before changing states
-	MIXER_LockAudioDevice();
-
 	// Prepare the channel to accept samples
 	if (should_enable) {
 		freq_counter = 0u;
 		// Don't start with a deficit
 		if (done < mixer.done)
 			done = mixer.done;
+		last_sound = PIC_Ticks;
 
 		// Prepare the channel to go dormant
 	} else {
@@ -226,14 +231,83 @@ void MixerChannel::Enable(const bool should_enable)
 		prev_sample[1] = 0;
 		next_sample[0] = 0;
 		next_sample[1] = 0;
+		ClearFilter();
 	}
 	is_enabled = should_enable;
-	MIXER_UnlockAudioDevice();
+}
+
+void MixerChannel::SetSleep(Bitu silence_ms, MIXER_IdleHandler idle) {
+	sleep_after = silence_ms;
+	sleep_idle = idle;
+	last_sound = PIC_Ticks;
+}
+
+/* Windowed sinc filter for every phase between two input samples. The
+ * taps sit at the times taps/2-1-i+phase relative to the output sample,
+ * so the output lags the input by half the filter length. */
+static void MIXER_MakeFilter(std::vector<int32_t> & coefs, Bitu taps, Bitu freq) {
+	constexpr double pi = 3.14159265358979323846;
+	const Bitu phases = 1 << FIR_PHASE_BITS;
+	// Cut off below the lower of both nyquist frequencies
+	double cutoff = 0.95;
+	if (freq > mixer.freq) cutoff *= (double)mixer.freq / freq;
+	const double half = taps / 2.0;
+	std::vector<double> h(taps);
+	coefs.resize(phases * taps);
+	for (Bitu p = 0; p < phases; p++) {
+		const double frac = (double)p / phases;
+		double sum = 0.0;
+		for (Bitu i = 0; i < taps; i++) {
+			const double x = half - 1 - i + frac;
+			const double u = x / half;
+			const double sinc = x ? sin(pi * cutoff * x) / (pi * cutoff * x) : 1.0;
+			const double blackman = 0.42 + 0.5 * cos(pi * u) + 0.08 * cos(2 * pi * u);
+			h[i] = sinc * blackman;
+			sum += h[i];
+		}
+		// Unity gain for every phase
+		for (Bitu i = 0; i < taps; i++)
+			coefs[p * taps + i] = (int32_t)lround(h[i] / sum * (1 << FIR_SHIFT));
+	}
 }
 
 void MixerChannel::SetFreq(Bitu freq) {
 	freq_add=(freq<<FREQ_SHIFT)/mixer.freq;
 	interpolate = (freq != mixer.freq);
+	if (interpolate && mixer.fir_taps) {
+		//Devices set their rate again for every block, keep the filter then
+		if (fir_taps && freq == fir_freq) return;
+		MIXER_MakeFilter(fir_coefs, mixer.fir_taps, freq);
+		fir_taps = mixer.fir_taps;
+		fir_freq = freq;
+	} else {
+		fir_coefs.clear();
+		fir_taps = 0;
+	}
+	ClearFilter();
+}
+
+void MixerChannel::ClearFilter() {
+	memset(fir_history, 0, sizeof(fir_history));
+	fir_pos = 0;
+}
+
+/* Remember a new input sample for the sinc filter */
+inline void MixerChannel::PushFilter(Bitu channel, Bits sample) {
+	fir_history[channel][fir_pos] = static_cast<int32_t>(sample);
+	fir_history[channel][fir_pos + fir_taps] = static_cast<int32_t>(sample);
+}
+
+/* Filtered output at the given position between the last two samples */
+inline Bits MixerChannel::Filter(Bitu channel, Bitu counter) const {
+	const int32_t * coef = &fir_coefs[((counter & FREQ_MASK) >> FIR_PHASE_SHIFT) * fir_taps];
+	//Oldest sample first
+	const int32_t * hist = &fir_history[channel][fir_pos + 1];
+	//32 bit sources overflow a 32 bit sum, so always use 64 bits
+	int64_t sample = 0;
+	for (Bitu i = 0; i < fir_taps; i++)
+		sample += static_cast<int64_t>(hist[i]) * coef[i];
+	return static_cast<Bits>(sample >> FIR_SHIFT);
 }
 
 void MixerChannel::Mix(Bitu _needed) {
@@ -244,6 +318,14 @@ void MixerChannel::Mix(Bitu _needed) {
 		left  = (left >> FREQ_SHIFT) + ((left & FREQ_MASK)!=0);
 		handler(left);
 	}
+	//Stop calling the device once it has nothing left to play
+	if (sleep_after && is_enabled && PIC_Ticks - last_sound >= sleep_after &&
+	    (!sleep_idle || sleep_idle())) {
+#ifdef DEBUG
+		LOG_MSG("MIXER %-7s channel: going to sleep", name);
+#endif
+		Enable(false);
+	}
 }
 
 void MixerChannel::AddSilence()
@@ -285,16 +367,104 @@ void MixerChannel::AddSilence()
 	}
 	last_samples_were_silence = true;
 	offset[0] = offset[1] = 0;
+	//Restart the filter from silence as well
+	if (fir_taps) ClearFilter();
 }
 
 //4 seems to work . Disabled for now
 #define MIXER_UPRAMP_STEPS 0
 #define MIXER_UPRAMP_SAVE 512
 
+/* Convert one incoming sample to the signed 16-bit range used for mixing */
+template<class Type,bool signeddata,bool nativeorder>
+static INLINE Bits MIXER_ConvertSample(const Type * data) {
+	if (sizeof(Type) == 1) {
+		if (!signeddata) return ((Bit8s)(data[0] ^ 0x80)) << 8;
+		return data[0] << 8;
+	}
+	//16bit and 32bit both contain 16bit data internally
+	if (signeddata) {
+		if (nativeorder) return data[0];
+		if (sizeof(Type) == 2) return (Bit16s)host_readw((HostPt)data);
+		return (Bit32s)host_readd((HostPt)data);
+	}
+	if (nativeorder) return (Bits)data[0]-32768;
+	if (sizeof(Type) == 2) return (Bits)host_readw((HostPt)data)-32768;
+	return (Bits)host_readd((HostPt)data)-32768;
+}
+
+/* Channel running at the mixer rate without remapping: every incoming
+ * sample becomes exactly one output sample, one step behind. Mix it in
+ * straight loops between the wraps of the work buffer. */
+template<class Type,bool stereo,bool signeddata,bool nativeorder>
+inline void MixerChannel::AddSamplesDirect(Bitu len, const Type* data) {
+	const Bits vol0 = volmul[0];
+	const Bits vol1 = volmul[1];
+	Bitu mixpos = (mixer.pos + done) & MIXER_BUFMASK;
+	//The pending sample goes first
+	mixer.work[mixpos][0] += next_sample[0] * vol0;
+	mixer.work[mixpos][1] += (stereo ? next_sample[1] : next_sample[0]) * vol1;
+	mixpos = (mixpos + 1) & MIXER_BUFMASK;
+	const Bitu count = len - 1;
+	for (Bitu i = 0; i < count;) {
+		Bitu run = MIXER_BUFSIZE - mixpos;
+		if (run > count - i) run = count - i;
+		Bit32s (* write)[2] = &mixer.work[mixpos];
+		const Type * src = &data[i * (stereo ? 2 : 1)];
+		for (Bitu j = 0; j < run; j++) {
+			if (stereo) {
+				write[j][0] += MIXER_ConvertSample<Type,signeddata,nativeorder>(&src[j*2+0]) * vol0;
+				write[j][1] += MIXER_ConvertSample<Type,signeddata,nativeorder>(&src[j*2+1]) * vol1;
+			} else {
+				const Bits sample = MIXER_ConvertSample<Type,signeddata,nativeorder>(&src[j]);
+				write[j][0] += sample * vol0;
+				write[j][1] += sample * vol1;
+			}
+		}
+		mixpos = (mixpos + run) & MIXER_BUFMASK;
+		i += run;
+	}
+	//Leave the state as the sample by sample loop would
+	const Type * last = &data[count * (stereo ? 2 : 1)];
+	if (count) {
+		const Type * before = last - (stereo ? 2 : 1);
+		prev_sample[0] = MIXER_ConvertSample<Type,signeddata,nativeorder>(&before[0]);
+		if (stereo) prev_sample[1] = MIXER_ConvertSample<Type,signeddata,nativeorder>(&before[1]);
+	} else {
+		prev_sample[0] = next_sample[0];
+		if (stereo) prev_sample[1] = next_sample[1];
+	}
+	next_sample[0] = MIXER_ConvertSample<Type,signeddata,nativeorder>(&last[0]);
+	if (stereo) next_sample[1] = MIXER_ConvertSample<Type,signeddata,nativeorder>(&last[1]);
+	done += len;
+	last_samples_were_silence = false;
+}
+
+/* Remember when the device last produced anything but digital silence */
+template<class Type,bool stereo,bool signeddata,bool nativeorder>
+inline void MixerChannel::TrackSilence(Bitu len, const Type* data) {
+	const Bitu count = stereo ? len * 2 : len;
+	for (Bitu i = 0; i < count; i++) {
+		if (MIXER_ConvertSample<Type,signeddata,nativeorder>(&data[i])) {
+			last_sound = PIC_Ticks;
+			return;
+		}
+	}
+}
+
 template<class Type,bool stereo,bool signeddata,bool nativeorder>
 inline void MixerChannel::AddSamples(Bitu len, const Type* data) {
 	last_samples_were_stereo = stereo;
-	
+	if (sleep_after) TrackSilence<Type,stereo,signeddata,nativeorder>(len,data);
+
+#if MIXER_UPRAMP_STEPS == 0
+	if (!interpolate && len && channel_map[0] == 0 && (!stereo || channel_map[1] == 1) &&
+	    freq_counter >= FREQ_NEXT && freq_counter < 2*FREQ_NEXT) {
+		AddSamplesDirect<Type,stereo,signeddata,nativeorder>(len,data);
+		return;
+	}
+#endif
+
 	//Position where to write the data
 	Bitu mixpos = mixer.pos + done;
 	//Position in the incoming data
@@ -324,75 +494,16 @@ inline void MixerChannel::AddSamples(Bitu len, const Type* data) {
 				prev_sample[1] = next_sample[1];
 			}
 
-			if ( sizeof( Type) == 1) {
-				if (!signeddata) {
-					if (stereo) {
-						next_sample[0]=(((Bit8s)(data[pos*2+0] ^ 0x80)) << 8);
-						next_sample[1]=(((Bit8s)(data[pos*2+1] ^ 0x80)) << 8);
-					} else {
-						next_sample[0]=(((Bit8s)(data[pos] ^ 0x80)) << 8);
-					}
-				} else {
-					if (stereo) {
-						next_sample[0]=(data[pos*2+0] << 8);
-						next_sample[1]=(data[pos*2+1] << 8);
-					} else {
-						next_sample[0]=(data[pos] << 8);
-					}
-				}
-			//16bit and 32bit both contain 16bit data internally
-			} else  {
-				if (signeddata) {
-					if (stereo) {
-						if (nativeorder) {
-							next_sample[0]=data[pos*2+0];
-							next_sample[1]=data[pos*2+1];
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bit16s)host_readw((HostPt)&data[pos*2+0]);
-								next_sample[1]=(Bit16s)host_readw((HostPt)&data[pos*2+1]);
-							} else {
-								next_sample[0]=(Bit32s)host_readd((HostPt)&data[pos*2+0]);
-								next_sample[1]=(Bit32s)host_readd((HostPt)&data[pos*2+1]);
-							}
-						}
-					} else {
-						if (nativeorder) {
-							next_sample[0] = data[pos];
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bit16s)host_readw((HostPt)&data[pos]);
-							} else {
-								next_sample[0]=(Bit32s)host_readd((HostPt)&data[pos]);
-							}
-						}
-					}
-				} else {
-					if (stereo) {
-						if (nativeorder) {
-							next_sample[0]=(Bits)data[pos*2+0]-32768;
-							next_sample[1]=(Bits)data[pos*2+1]-32768;
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bits)host_readw((HostPt)&data[pos*2+0])-32768;
-								next_sample[1]=(Bits)host_readw((HostPt)&data[pos*2+1])-32768;
-							} else {
-								next_sample[0]=(Bits)host_readd((HostPt)&data[pos*2+0])-32768;
-								next_sample[1]=(Bits)host_readd((HostPt)&data[pos*2+1])-32768;
-							}
-						}
-					} else {
-						if (nativeorder) {
-							next_sample[0]=(Bits)data[pos]-32768;
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bits)host_readw((HostPt)&data[pos])-32768;
-							} else {
-								next_sample[0]=(Bits)host_readd((HostPt)&data[pos])-32768;
-							}
-						}
-					}
-				}
+			if (stereo) {
+				next_sample[0]=MIXER_ConvertSample<Type,signeddata,nativeorder>(&data[pos*2+0]);
+				next_sample[1]=MIXER_ConvertSample<Type,signeddata,nativeorder>(&data[pos*2+1]);
+			} else {
+				next_sample[0]=MIXER_ConvertSample<Type,signeddata,nativeorder>(&data[pos]);
+			}
+			if (fir_taps) {
+				if (++fir_pos >= fir_taps) fir_pos = 0;
+				PushFilter(0, next_sample[0]);
+				if (stereo) PushFilter(1, next_sample[1]);
 			}
 			//This sample has been handled now, increase position
 			pos++;
@@ -427,6 +538,12 @@ inline void MixerChannel::AddSamples(Bitu len, const Type* data) {
 			write[0] += prev_sample[left_map] * volmul[0];
 			write[1] += (stereo ? prev_sample[right_map] : prev_sample[left_map]) * volmul[1];
 		}
+		else if (fir_taps) {
+			Bits sample = Filter(stereo ? left_map : 0, freq_counter);
+			write[0] += sample*volmul[0];
+			if (stereo) sample = Filter(right_map, freq_counter);
+			write[1] += sample*volmul[1];
+		}
 		else {
 			Bits diff_mul = freq_counter & FREQ_MASK;
 			Bits sample = prev_sample[left_map] + (((next_sample[left_map] - prev_sample[left_map]) * diff_mul) >> FREQ_SHIFT);
@@ -455,6 +572,7 @@ void MixerChannel::AddStretched(Bitu len,Bit16s * data) {
 	Bitu mixpos = mixer.pos + done;
 	done = needed;
 	Bitu pos = 0;
+	if (sleep_after) TrackSilence<Bit16s,false,true,true>(len,data);
 
 	while (outlen--) {
 		Bitu new_pos = index >> FREQ_SHIFT;
@@ -529,9 +647,7 @@ void MixerChannel::FillUp()
 	if (!is_enabled || done < mixer.done)
 		return;
 	float index = PIC_TickIndex();
-	MIXER_LockAudioDevice();
 	Mix((Bitu)(index * mixer.needed));
-	MIXER_UnlockAudioDevice();
 }
 
 extern bool ticksLocked;
@@ -581,14 +697,92 @@ static void MIXER_MixData(Bitu needed) {
 	mixer.done = needed;
 }
 
-static void MIXER_Mix()
+/* The work buffer has been handed off, prepare for the next tick */
+static void MIXER_NextTick()
 {
-	MIXER_LockAudioDevice();
-	MIXER_MixData(mixer.needed);
+	/* Reduce count in channels */
+	for (MixerChannel * chan=mixer.channels;chan;chan=chan->next) {
+		if (chan->done>mixer.needed) chan->done-=mixer.needed;
+		else chan->done=0;
+	}
+	/* Set values for next tick */
 	mixer.tick_counter += mixer.tick_add;
-	mixer.needed+=(mixer.tick_counter >> TICK_SHIFT);
+	mixer.needed = (mixer.tick_counter >> TICK_SHIFT);
 	mixer.tick_counter &= TICK_MASK;
-	MIXER_UnlockAudioDevice();
+	mixer.done=0;
+}
+
+/* Move the samples of this tick into the ring, returns the frames dropped */
+static Bitu MIXER_QueueSamples(Bitu count)
+{
+	const Bitu read = mixer.ring.read.load(std::memory_order_acquire);
+	Bitu write = mixer.ring.write.load(std::memory_order_relaxed);
+	const Bitu space = MIXER_BUFSIZE - (write - read);
+	const Bitu queue = count < space ? count : space;
+	/* Convert in straight runs between the wraps of both buffers */
+	for (Bitu i = 0; i < queue;) {
+		const Bitu w = write & MIXER_BUFMASK;
+		Bitu run = queue - i;
+		if (run > MIXER_BUFSIZE - w) run = MIXER_BUFSIZE - w;
+		if (run > MIXER_BUFSIZE - mixer.pos) run = MIXER_BUFSIZE - mixer.pos;
+		const int32_t (* src)[2] = &mixer.work[mixer.pos];
+		int16_t (* dst)[2] = &mixer.ring.frames[w];
+		for (Bitu j = 0; j < run; j++) {
+			dst[j][0] = MIXER_CLIP(src[j][0] >> MIXER_VOLSHIFT);
+			dst[j][1] = MIXER_CLIP(src[j][1] >> MIXER_VOLSHIFT);
+		}
+		memset(&mixer.work[mixer.pos], 0, run * sizeof(mixer.work[0]));
+		mixer.pos = (mixer.pos + run) & MIXER_BUFMASK;
+		write += run;
+		i += run;
+	}
+	mixer.ring.write.store(write, std::memory_order_release);
+	/* No room left, the rest is lost */
+	for (Bitu i = queue; i < count; i++) {
+		mixer.work[mixer.pos][0]=0;
+		mixer.work[mixer.pos][1]=0;
+		mixer.pos=(mixer.pos+1)&MIXER_BUFMASK;
+	}
+	return count - queue;
+}
+
+/* Steer the amount of samples generated per tick so the device always
+ * finds about min_needed frames left over after taking a block */
+static void MIXER_AdjustTickAdd()
+{
+	if (Mixer_irq_important()) {
+		mixer.tick_add = calc_tickadd(mixer.freq);
+		return;
+	}
+	const Bitu left = mixer.ring.left.load(std::memory_order_relaxed);
+	if (left < mixer.min_needed) {
+		Bitu diff = mixer.min_needed - left;
+		mixer.tick_add = calc_tickadd(mixer.freq+(diff*3));
+		return;
+	}
+	/* Mixer tick value being updated:
+	 * 3 cases:
+	 * 1) A lot too high. >division by 5. but maxed by 2* min to prevent too fast drops.
+	 * 2) A little too high > division by 8
+	 * 3) A little to nothing above the min_needed buffer > go to default value
+	 */
+	Bitu diff = left - mixer.min_needed;
+	if(diff > (mixer.min_needed<<1)) diff = mixer.min_needed<<1;
+	if(diff > (mixer.min_needed>>1))
+		mixer.tick_add = calc_tickadd(mixer.freq-(diff/5));
+	else if (diff > (mixer.min_needed>>2))
+		mixer.tick_add = calc_tickadd(mixer.freq-(diff>>3));
+	else
+		mixer.tick_add = calc_tickadd(mixer.freq);
+}
+
+static void MIXER_Mix()
+{
+	MIXER_MixData(mixer.needed);
+	const Bitu dropped = MIXER_QueueSamples(mixer.needed);
+	if (dropped) mixer.ring.dropped.fetch_add(dropped, std::memory_order_relaxed);
+	MIXER_AdjustTickAdd();
+	MIXER_NextTick();
 }
 
 static void MIXER_Mix_NoSound()
@@ -600,124 +794,40 @@ static void MIXER_Mix_NoSound()
 		mixer.work[mixer.pos][1]=0;
 		mixer.pos=(mixer.pos+1)&MIXER_BUFMASK;
 	}
-	/* Reduce count in channels */
-	for (MixerChannel * chan=mixer.channels;chan;chan=chan->next) {
-		if (chan->done>mixer.needed) chan->done-=mixer.needed;
-		else chan->done=0;
-	}
-	/* Set values for next tick */
-	mixer.tick_counter += mixer.tick_add;
-	mixer.needed = (mixer.tick_counter >> TICK_SHIFT);
-	mixer.tick_counter &= TICK_MASK;
-	mixer.done=0;
+	MIXER_NextTick();
 }
 
 static void SDLCALL MIXER_CallBack(void * userdata, Uint8 *stream, int len) {
-	memset(stream, 0, len);
 	Bitu need=(Bitu)len/MIXER_SSIZE;
 	Bit16s * output=(Bit16s *)stream;
-	Bitu reduce;
-	Bitu pos;
-	//Local resampling counter to manipulate the data when sending it off to the callback
-	Bitu index, index_add;
-	Bits sample;
-	/* Enough room in the buffer ? */
-	if (mixer.done < need) {
-//		LOG_MSG("Full underrun need %d, have %d, min %d", need, mixer.done, mixer.min_needed);
-		if((need - mixer.done) > (need >>7) ) //Max 1 procent stretch.
-			return;
-		reduce = mixer.done;
-		index_add = (reduce << TICK_SHIFT) / need;
-		mixer.tick_add = calc_tickadd(mixer.freq+mixer.min_needed);
-	} else if (mixer.done < mixer.max_needed) {
-		Bitu left = mixer.done - need;
-		if (left < mixer.min_needed) {
-			if( !Mixer_irq_important() ) {
-				Bitu needed = mixer.needed - need;
-				Bitu diff = (mixer.min_needed>needed?mixer.min_needed:needed) - left;
-				mixer.tick_add = calc_tickadd(mixer.freq+(diff*3));
-				left = 0; //No stretching as we compensate with the tick_add value
-			} else {
-				left = (mixer.min_needed - left);
-				left = 1 + (2*left) / mixer.min_needed; //left=1,2,3
-			}
-//			LOG_MSG("needed underrun need %d, have %d, min %d, left %d", need, mixer.done, mixer.min_needed, left);
-			reduce = need - left;
-			index_add = (reduce << TICK_SHIFT) / need;
-		} else {
-			reduce = need;
-			index_add = (1 << TICK_SHIFT);
-//			LOG_MSG("regular run need %d, have %d, min %d, left %d", need, mixer.done, mixer.min_needed, left);
-
-			/* Mixer tick value being updated:
-			 * 3 cases:
-			 * 1) A lot too high. >division by 5. but maxed by 2* min to prevent too fast drops.
-			 * 2) A little too high > division by 8
-			 * 3) A little to nothing above the min_needed buffer > go to default value
-			 */
-			Bitu diff = left - mixer.min_needed;
-			if(diff > (mixer.min_needed<<1)) diff = mixer.min_needed<<1;
-			if(diff > (mixer.min_needed>>1))
-				mixer.tick_add = calc_tickadd(mixer.freq-(diff/5));
-			else if (diff > (mixer.min_needed>>2))
-				mixer.tick_add = calc_tickadd(mixer.freq-(diff>>3));
-			else
-				mixer.tick_add = calc_tickadd(mixer.freq);
-		}
-	} else {
-		/* There is way too much data in the buffer */
-//		LOG_MSG("overflow run need %d, have %d, min %d", need, mixer.done, mixer.min_needed);
-		if (mixer.done > MIXER_BUFSIZE)
-			index_add = MIXER_BUFSIZE - 2*mixer.min_needed;
-		else
-			index_add = mixer.done - 2*mixer.min_needed;
-		index_add = (index_add << TICK_SHIFT) / need;
-		reduce = mixer.done - 2* mixer.min_needed;
-		mixer.tick_add = calc_tickadd(mixer.freq-(mixer.min_needed/5));
-	}
-	/* Reduce done count in all channels */
-	for (MixerChannel * chan=mixer.channels;chan;chan=chan->next) {
-		if (chan->done>reduce) chan->done-=reduce;
-		else chan->done=0;
+	const Bitu write = mixer.ring.write.load(std::memory_order_acquire);
+	Bitu read = mixer.ring.read.load(std::memory_order_relaxed);
+	Bitu avail = write - read;
+	/* There is way too much data in the ring, skip the oldest part */
+	if (avail > mixer.max_needed + need) {
+		const Bitu skip = avail - mixer.max_needed - need;
+		mixer.ring.dropped.fetch_add(skip, std::memory_order_relaxed);
+		read += skip;
+		avail -= skip;
 	}
-
-	// Reset mixer.tick_add when irqs are important
-	if( Mixer_irq_important() )
-		mixer.tick_add = calc_tickadd(mixer.freq);
-
-	mixer.done -= reduce;
-	mixer.needed -= reduce;
-	pos = mixer.pos;
-	mixer.pos = (mixer.pos + reduce) & MIXER_BUFMASK;
-	index = 0;
-	if(need != reduce) {
-		while (need--) {
-			Bitu i = (pos + (index >> TICK_SHIFT )) & MIXER_BUFMASK;
-			index += index_add;
-			sample=mixer.work[i][0]>>MIXER_VOLSHIFT;
-			*output++=MIXER_CLIP(sample);
-			sample=mixer.work[i][1]>>MIXER_VOLSHIFT;
-			*output++=MIXER_CLIP(sample);
-		}
-		/* Clean the used buffer */
-		while (reduce--) {
-			pos &= MIXER_BUFMASK;
-			mixer.work[pos][0]=0;
-			mixer.work[pos][1]=0;
-			pos++;
-		}
-	} else {
-		while (reduce--) {
-			pos &= MIXER_BUFMASK;
-			sample=mixer.work[pos][0]>>MIXER_VOLSHIFT;
-			*output++=MIXER_CLIP(sample);
-			sample=mixer.work[pos][1]>>MIXER_VOLSHIFT;
-			*output++=MIXER_CLIP(sample);
-			mixer.work[pos][0]=0;
-			mixer.work[pos][1]=0;
-			pos++;
-		}
+	const Bitu count = avail < need ? avail : need;
+	for (Bitu i=0;i<count;i++) {
+		const Bitu r = (read + i) & MIXER_BUFMASK;
+		*output++=mixer.ring.frames[r][0];
+		*output++=mixer.ring.frames[r][1];
 	}
+	if (count < need) {
+		memset(output, 0, (need - count) * MIXER_SSIZE);
+		mixer.ring.underruns.fetch_add(1, std::memory_order_relaxed);
+	}
+	mixer.ring.read.store(read + count, std::memory_order_release);
+
+	const Bitu left = avail - count;
+	mixer.ring.left.store(left, std::memory_order_relaxed);
+	if (left < mixer.ring.left_min.load(std::memory_order_relaxed))
+		mixer.ring.left_min.store(left, std::memory_order_relaxed);
+	if (left > mixer.ring.left_max.load(std::memory_order_relaxed))
+		mixer.ring.left_max.store(left, std::memory_order_relaxed);
 }
 
 static void MIXER_Stop(Section* sec) {
@@ -767,6 +877,10 @@ public:
 			chan->UpdateVolume();
 			chan = chan->next;
 		}
+		if (cmd->FindExist("/STATS")) {
+			ShowStats();
+			return;
+		}
 		if (cmd->FindExist("/NOSHOW")) return;
 		WriteOut("Channel  Main    Main(dB)\n");
 		ShowVolume("MASTER",mixer.mastervol[0],mixer.mastervol[1]);
@@ -782,6 +896,34 @@ private:
 		);
 	}
 
+	void ShowStats() {
+		if (mixer.nosound) {
+			WriteOut("No audio device is open.\n");
+			return;
+		}
+		const Bitu freq = mixer.freq ? mixer.freq : 1;
+		/* The minimum and maximum restart with every query */
+		const Bitu left = mixer.ring.left.load(std::memory_order_relaxed);
+		const Bitu left_min = mixer.ring.left_min.exchange(~(Bitu)0, std::memory_order_relaxed);
+		const Bitu left_max = mixer.ring.left_max.exchange(0, std::memory_order_relaxed);
+		WriteOut("Audio buffer    %u frames of %u, %u ms\n",
+		         (unsigned)left,(unsigned)MIXER_BUFSIZE,(unsigned)(left*1000/freq));
+		if (left_min <= left_max)
+			WriteOut("Since last query %u to %u ms\n",
+			         (unsigned)(left_min*1000/freq),(unsigned)(left_max*1000/freq));
+		WriteOut("Target          %u ms, device block %u frames\n",
+		         (unsigned)(mixer.min_needed*1000/freq),(unsigned)mixer.blocksize);
+		WriteOut("Underruns       %u\n",(unsigned)mixer.ring.underruns.load(std::memory_order_relaxed));
+		WriteOut("Dropped frames  %u\n",(unsigned)mixer.ring.dropped.load(std::memory_order_relaxed));
+		SB_DMA_Stats sb;
+		if (SB_Get_DMA_Stats(sb)) {
+			WriteOut("SB DMA calls    %llu, %llu bytes, %llu without a copy\n",
+			         (unsigned long long)sb.calls,(unsigned long long)sb.bytes,
+			         (unsigned long long)sb.direct);
+			WriteOut("SB underruns    %llu\n",(unsigned long long)sb.underruns);
+		}
+	}
+
 	void ListMidi() { MIDI_ListAll(this); }
 };
 
@@ -815,12 +957,24 @@ void MIXER_Init(Section* sec) {
 	mixer.freq=section->Get_int("rate");
 	mixer.nosound=section->Get_bool("nosound");
 	mixer.blocksize=section->Get_int("blocksize");
+	const std::string resampling = section->Get_string("resampling");
+	if (resampling == "sinc8") mixer.fir_taps=8;
+	else if (resampling == "sinc16") mixer.fir_taps=16;
+	else if (resampling == "sinc32") mixer.fir_taps=32;
+	else mixer.fir_taps=0;
 
 	/* Initialize the internal stuff */
 	mixer.channels=0;
 	mixer.pos=0;
 	mixer.done=0;
 	memset(mixer.work,0,sizeof(mixer.work));
+	mixer.ring.write=0;
+	mixer.ring.read=0;
+	mixer.ring.left=0;
+	mixer.ring.left_min=~(Bitu)0;
+	mixer.ring.left_max=0;
+	mixer.ring.underruns=0;
+	mixer.ring.dropped=0;
 	mixer.mastervol[0]=1.0f;
 	mixer.mastervol[1]=1.0f;
 
@@ -852,13 +1006,15 @@ void MIXER_Init(Section* sec) {
 		mixer.blocksize=obtained.samples;
 		mixer.tick_add=calc_tickadd(mixer.freq);
 		TIMER_AddTickHandler(MIXER_Mix);
-		SDL_PauseAudioDevice(mixer.sdldevice, 0);
 	}
 	mixer.min_needed=section->Get_int("prebuffer");
 	if (mixer.min_needed>100) mixer.min_needed=100;
 	mixer.min_needed=(mixer.freq*mixer.min_needed)/1000;
 	mixer.max_needed=mixer.blocksize * 2 + 2*mixer.min_needed;
 	mixer.needed=mixer.min_needed+1;
+	/* The callback uses the buffer limits, only start it now */
+	if (!mixer.nosound)
+		SDL_PauseAudioDevice(mixer.sdldevice, 0);
 	PROGRAMS_MakeFile("MIXER.COM",MIXER_ProgramStart);
 }
 
@@ -30,7 +30,15 @@
 #define SPKR_POSITIVE_VOLTAGE 5000.0f
 #define SPKR_NEUTRAL_VOLTAGE  0.0f
 #define SPKR_NEGATIVE_VOLTAGE -SPKR_POSITIVE_VOLTAGE
-#define SPKR_SPEED (SPKR_POSITIVE_VOLTAGE * 2.0f / 0.070f)
+
+/* Band-limited step synthesis: every voltage change adds a windowed sinc
+ * impulse into a delta buffer, which is integrated into the output once
+ * per sample. Impulses are placed with 1/SPKR_BLEP_PHASES sample precision
+ * and cost SPKR_BLEP_WIDTH taps each, regardless of the output length. */
+#define SPKR_BLEP_WIDTH 16
+#define SPKR_BLEP_PHASES 64
+#define SPKR_BLEP_CUTOFF 0.90 // fraction of nyquist
+#define SPKR_MAX_SAMPLES (MIXER_BUFSIZE / sizeof(Bit16s))
 
 enum SPKR_MODES {
 	SPKR_OFF,SPKR_ON,SPKR_PIT_OFF,SPKR_PIT_ON
@@ -57,10 +65,54 @@ static struct {
 	float pit_index = 0.0f;
 	float volwant = 0.0f;
 	float volcur = 0.0f;
+	float accum = 0.0f;
+	float deltas[SPKR_MAX_SAMPLES + SPKR_BLEP_WIDTH] = {};
 	float last_index = 0.0f;
 	uint8_t idle_countdown = 0u;
 } spkr;
 
+static float blep_kernel[SPKR_BLEP_PHASES][SPKR_BLEP_WIDTH];
+
+// Builds the Blackman windowed sinc impulses, one per sub-sample phase.
+// Each phase is normalized to unit sum so a step always settles exactly.
+static void InitBlepKernel()
+{
+	constexpr double pi = 3.14159265358979323846;
+	constexpr double half = SPKR_BLEP_WIDTH / 2;
+	for (int p = 0; p < SPKR_BLEP_PHASES; p++) {
+		const double frac = (double)p / SPKR_BLEP_PHASES;
+		double taps[SPKR_BLEP_WIDTH];
+		double sum = 0.0;
+		for (int k = 0; k < SPKR_BLEP_WIDTH; k++) {
+			const double x = k - half - frac + 1.0;
+			if (fabs(x) >= half) {
+				taps[k] = 0.0;
+				continue;
+			}
+			const double w = (x + half) / (2.0 * half);
+			const double window = 0.42 - 0.5 * cos(2.0 * pi * w) +
+			                      0.08 * cos(4.0 * pi * w);
+			const double arg = pi * SPKR_BLEP_CUTOFF * x;
+			const double sinc = x == 0.0 ? 1.0 : sin(arg) / arg;
+			taps[k] = window * sinc;
+			sum += taps[k];
+		}
+		for (int k = 0; k < SPKR_BLEP_WIDTH; k++)
+			blep_kernel[p][k] = (float)(taps[k] / sum);
+	}
+}
+
+// Adds a band-limited step of the given size at a fractional sample position
+static void AddStep(float pos, float delta)
+{
+	const Bitu i = (Bitu)pos;
+	const Bitu phase = (Bitu)((pos - i) * SPKR_BLEP_PHASES);
+	const float *kernel = blep_kernel[std::min<Bitu>(phase, SPKR_BLEP_PHASES - 1)];
+	float *out = &spkr.deltas[i];
+	for (int k = 0; k < SPKR_BLEP_WIDTH; k++)
+		out[k] += kernel[k] * delta;
+}
+
 static bool SpeakerExists()
 {
 	// If the mixer's channel doesn't exist, then dosbox
@@ -309,60 +361,44 @@ static void PCSPEAKER_CallBack(Bitu len)
 	if (!SpeakerExists())
 		return;
 
-	Bit16s * stream=(Bit16s*)MixTemp;
+	len = std::min<Bitu>(len, SPKR_MAX_SAMPLES);
 	ForwardPIT(1);
 	spkr.last_index=0;
-	Bitu count=len;
+	/* A fade set up in the previous block takes effect at its start */
+	if (spkr.volwant != spkr.volcur) {
+		AddStep(0, spkr.volwant - spkr.volcur);
+		spkr.volcur = spkr.volwant;
+	}
+	/* Turn the queued voltage changes into steps */
+	const float scale = (float)len;
 	uint16_t pos = 0;
-	float sample_base=0;
-	float sample_add=(1.0001f)/len;
-	while (count--) {
-		float index=sample_base;
-		sample_base+=sample_add;
-		float end=sample_base;
-		float value = 0;
-		while(index<end) {
-			/* Check if there is an upcoming event */
-			if (spkr.used && spkr.entries[pos].index<=index) {
-				spkr.volwant=spkr.entries[pos].vol;
-				pos++;spkr.used--;
-				continue;
-			}
-			float vol_end;
-			if (spkr.used && spkr.entries[pos].index<end) {
-				vol_end=spkr.entries[pos].index;
-			} else vol_end=end;
-			float vol_len=vol_end-index;
-            /* Check if we have to slide the volume */
-			float vol_diff=spkr.volwant-spkr.volcur;
-			if (vol_diff == 0) {
-				value+=spkr.volcur*vol_len;
-				index+=vol_len;
-			} else {
-				/* Check how long it will take to goto new level */
-				float vol_time=fabsf(vol_diff)/SPKR_SPEED;
-				if (vol_time<=vol_len) {
-					/* Volume reaches endpoint in this block, calc until that point */
-					value+=vol_time*spkr.volcur;
-					value+=vol_time*vol_diff/2;
-					index+=vol_time;
-					spkr.volcur=spkr.volwant;
-				} else {
-					/* Volume still not reached in this block */
-					value+=spkr.volcur*vol_len;
-					if (vol_diff<0) {
-						value-=(SPKR_SPEED*vol_len*vol_len)/2;
-						spkr.volcur-=SPKR_SPEED*vol_len;
-					} else {
-						value+=(SPKR_SPEED*vol_len*vol_len)/2;
-						spkr.volcur+=SPKR_SPEED*vol_len;
-					}
-					index+=vol_len;
-				}
-			}
-		}
-		*stream++=(Bit16s)(value/sample_add);
+	for (; pos < spkr.used; pos++) {
+		const float vol = spkr.entries[pos].vol;
+		if (vol == spkr.volcur)
+			continue;
+		const float index = spkr.entries[pos].index * scale;
+		AddStep(std::min(std::max(index, 0.0f), scale), vol - spkr.volcur);
+		spkr.volcur = vol;
+	}
+	spkr.volwant = spkr.volcur;
+	spkr.used = 0;
+	/* Integrate the deltas into the output */
+	Bit16s * stream=(Bit16s*)MixTemp;
+	float accum = spkr.accum;
+	for (Bitu i = 0; i < len; i++) {
+		accum += spkr.deltas[i];
+		stream[i] = (Bit16s)accum;
+	}
+	/* Carry the tails of steps near the end into the next block */
+	float tail = 0.0f;
+	for (Bitu k = 0; k < SPKR_BLEP_WIDTH; k++) {
+		spkr.deltas[k] = spkr.deltas[len + k];
+		tail += spkr.deltas[k];
 	}
+	std::fill_n(&spkr.deltas[SPKR_BLEP_WIDTH], len, 0.0f);
+	/* Once the tails are in, the level has to be volcur, so drop any
+	 * rounding drift from the running sum here */
+	spkr.accum = spkr.volcur - tail;
 	spkr.chan->AddSamples_m16(len,(Bit16s*)MixTemp);
 	FadeVolume(pos);
 }
@@ -377,6 +413,7 @@ public:
 			return;
 		spkr.rate = std::max(section->Get_int("pcrate"), 8000);
 		spkr.min_tr = (PIT_TICK_RATE + spkr.rate / 2 - 1) / (spkr.rate / 2);
+		InitBlepKernel();
 		/* Register the sound channel */
 		spkr.chan = MixerChan.Install(&PCSPEAKER_CallBack, spkr.rate, "SPKR");
 	}
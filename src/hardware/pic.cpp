@@ -24,7 +24,11 @@
 #include "timer.h"
 #include "setup.h"
 
+#include <vector>
+
+/* Initial size of the event pool, it grows when more events are pending */
 #define PIC_QUEUESIZE 512
+#define PIC_NOT_QUEUED (~(Bitu)0)
 
 struct PIC_Controller {
 	Bitu icw_words;
@@ -164,19 +168,94 @@ void PIC_Controller::start_irq(Bit8u val){
 }
 
 
+/*
+	Timed events are kept in a binary min-heap of indices into a growable
+	pool of entries. Events are ordered by their absolute time in PIC ticks
+	(milliseconds); events scheduled for the same time run in the order in
+	which they were added. Every pool slot carries a generation counter so
+	the handle returned by PIC_AddEvent goes stale once the event has run
+	or was removed.
+*/
 struct PICEntry {
-	float index;
+	double time;				//Absolute time in PIC ticks
 	Bitu value;
 	PIC_EventHandler pic_event;
-	PICEntry * next;
+	Bit64u order;				//Insertion order, tie-breaker for equal times
+	Bitu heap_pos;				//Position in the heap or PIC_NOT_QUEUED
+	Bit32u generation;
 };
 
 static struct {
-	PICEntry entries[PIC_QUEUESIZE];
-	PICEntry * free_entry;
-	PICEntry * next_entry;
+	std::vector<PICEntry> entries;
+	std::vector<Bitu> free_slots;
+	std::vector<Bitu> heap;
+	Bit64u next_order;
 } pic_queue;
 
+static PIC_EventStats pic_stats;
+static struct {
+	Bit64u dispatched;
+	Bit64u depth_sum;
+	Bitu ticks;
+} pic_stats_second;
+
+static INLINE double PIC_EntryIndex(const PICEntry & entry) {
+	return entry.time-(double)PIC_Ticks;
+}
+
+static INLINE bool PIC_EntryBefore(Bitu a,Bitu b) {
+	const PICEntry & ea=pic_queue.entries[a];
+	const PICEntry & eb=pic_queue.entries[b];
+	if (ea.time!=eb.time) return ea.time<eb.time;
+	return ea.order<eb.order;
+}
+
+static INLINE void PIC_HeapSet(Bitu pos,Bitu slot) {
+	pic_queue.heap[pos]=slot;
+	pic_queue.entries[slot].heap_pos=pos;
+}
+
+static void PIC_HeapSiftUp(Bitu pos) {
+	const Bitu slot=pic_queue.heap[pos];
+	while (pos) {
+		const Bitu parent=(pos-1)/2;
+		if (!PIC_EntryBefore(slot,pic_queue.heap[parent])) break;
+		PIC_HeapSet(pos,pic_queue.heap[parent]);
+		pos=parent;
+	}
+	PIC_HeapSet(pos,slot);
+}
+
+static void PIC_HeapSiftDown(Bitu pos) {
+	const Bitu size=pic_queue.heap.size();
+	const Bitu slot=pic_queue.heap[pos];
+	for (;;) {
+		Bitu child=pos*2+1;
+		if (child>=size) break;
+		if (child+1<size && PIC_EntryBefore(pic_queue.heap[child+1],pic_queue.heap[child])) child++;
+		if (!PIC_EntryBefore(pic_queue.heap[child],slot)) break;
+		PIC_HeapSet(pos,pic_queue.heap[child]);
+		pos=child;
+	}
+	PIC_HeapSet(pos,slot);
+}
+
+/* Takes an entry out of the heap and returns its slot to the pool */
+static void PIC_HeapRemove(Bitu slot) {
+	PICEntry & entry=pic_queue.entries[slot];
+	const Bitu pos=entry.heap_pos;
+	const Bitu last=pic_queue.heap.back();
+	pic_queue.heap.pop_back();
+	if (last!=slot) {
+		PIC_HeapSet(pos,last);
+		if (pos && PIC_EntryBefore(last,pic_queue.heap[(pos-1)/2])) PIC_HeapSiftUp(pos);
+		else PIC_HeapSiftDown(pos);
+	}
+	entry.heap_pos=PIC_NOT_QUEUED;
+	entry.generation++;
+	pic_queue.free_slots.push_back(slot);
+}
+
 static void write_command(Bitu port,Bitu val,Bitu iolen) {
 	PIC_Controller * pic=&pics[port==0x20 ? 0 : 1];
 
@@ -378,102 +457,77 @@ void PIC_SetIRQMask(Bitu irq, bool masked) {
 	pic->set_imr(newmask);
 }
 
-static void AddEntry(PICEntry * entry) {
-	PICEntry * find_entry=pic_queue.next_entry;
-	if (GCC_UNLIKELY(find_entry ==0)) {
-		entry->next=0;
-		pic_queue.next_entry=entry;
-	} else if (find_entry->index>entry->index) {
-		pic_queue.next_entry=entry;
-		entry->next=find_entry;
-	} else while (find_entry) {
-		if (find_entry->next) {
-			/* See if the next index comes later than this one */
-			if (find_entry->next->index > entry->index) {
-				entry->next=find_entry->next;
-				find_entry->next=entry;
-				break;
-			} else {
-				find_entry=find_entry->next;
-			}
-		} else {
-			entry->next=find_entry->next;
-			find_entry->next=entry;
-			break;
-		}
+static bool InEventService = false;
+static double srv_lag = 0;
+
+PIC_EventId PIC_AddEvent(PIC_EventHandler handler,float delay,Bitu val) {
+	Bitu slot;
+	if (GCC_UNLIKELY(pic_queue.free_slots.empty())) {
+		slot=pic_queue.entries.size();
+		pic_queue.entries.push_back(PICEntry());
+		pic_queue.entries[slot].generation=0;
+		pic_stats.pool_size=pic_queue.entries.size();
+	} else {
+		slot=pic_queue.free_slots.back();
+		pic_queue.free_slots.pop_back();
 	}
-	Bits cycles=PIC_MakeCycles(pic_queue.next_entry->index-PIC_TickIndex());
-	if (cycles<CPU_Cycles) {
-		CPU_CycleLeft+=CPU_Cycles;
-		CPU_Cycles=0;
+	PICEntry & entry=pic_queue.entries[slot];
+	if(InEventService) entry.time = (double)PIC_Ticks + srv_lag + delay;
+	else entry.time = (double)PIC_Ticks + PIC_TickIndex() + delay;
+
+	entry.pic_event=handler;
+	entry.value=val;
+	entry.order=pic_queue.next_order++;
+	pic_queue.heap.push_back(slot);
+	PIC_HeapSiftUp(pic_queue.heap.size()-1);
+
+	pic_stats.added++;
+	if (pic_queue.heap.size()>pic_stats.peak_depth) pic_stats.peak_depth=pic_queue.heap.size();
+
+	/* Shorten the current cycle slice if this event comes first */
+	if (pic_queue.heap[0]==slot) {
+		Bits cycles=PIC_MakeCycles(PIC_EntryIndex(entry)-PIC_TickIndex());
+		if (cycles<CPU_Cycles) {
+			CPU_CycleLeft+=CPU_Cycles;
+			CPU_Cycles=0;
+		}
 	}
+	return ((PIC_EventId)entry.generation<<32)|(PIC_EventId)(slot+1);
 }
-static bool InEventService = false;
-static float srv_lag = 0;
 
-void PIC_AddEvent(PIC_EventHandler handler,float delay,Bitu val) {
-	if (GCC_UNLIKELY(!pic_queue.free_entry)) {
-		LOG(LOG_PIC,LOG_ERROR)("Event queue full");
-		return;
-	}
-	PICEntry * entry=pic_queue.free_entry;
-	if(InEventService) entry->index = delay + srv_lag;
-	else entry->index = delay + PIC_TickIndex();
+void PIC_RemoveEvent(PIC_EventId id) {
+	const Bitu slot=(Bitu)(id & 0xffffffff);
+	if (!slot || slot>pic_queue.entries.size()) return;
+	const PICEntry & entry=pic_queue.entries[slot-1];
+	if (entry.generation!=(Bit32u)(id>>32) || entry.heap_pos==PIC_NOT_QUEUED) return;
+	PIC_HeapRemove(slot-1);
+}
 
-	entry->pic_event=handler;
-	entry->value=val;
-	pic_queue.free_entry=pic_queue.free_entry->next;
-	AddEntry(entry);
+/* Collect the matching slots first, removing reorders the heap */
+template <typename Match>
+static void PIC_RemoveMatching(Match match) {
+	static std::vector<Bitu> matches;
+	matches.clear();
+	for (Bitu slot : pic_queue.heap) {
+		if (GCC_UNLIKELY(match(pic_queue.entries[slot]))) matches.push_back(slot);
+	}
+	for (Bitu slot : matches) PIC_HeapRemove(slot);
 }
 
 void PIC_RemoveSpecificEvents(PIC_EventHandler handler, Bitu val) {
-	PICEntry * entry=pic_queue.next_entry;
-	PICEntry * prev_entry;
-	prev_entry = 0;
-	while (entry) {
-		if (GCC_UNLIKELY((entry->pic_event == handler)) && (entry->value == val)) {
-			if (prev_entry) {
-				prev_entry->next=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=prev_entry->next;
-				continue;
-			} else {
-				pic_queue.next_entry=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=pic_queue.next_entry;
-				continue;
-			}
-		}
-		prev_entry=entry;
-		entry=entry->next;
-	}	
+	PIC_RemoveMatching([=](const PICEntry & entry) {
+		return entry.pic_event==handler && entry.value==val;
+	});
 }
 
 void PIC_RemoveEvents(PIC_EventHandler handler) {
-	PICEntry * entry=pic_queue.next_entry;
-	PICEntry * prev_entry;
-	prev_entry=0;
-	while (entry) {
-		if (GCC_UNLIKELY(entry->pic_event==handler)) {
-			if (prev_entry) {
-				prev_entry->next=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=prev_entry->next;
-				continue;
-			} else {
-				pic_queue.next_entry=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=pic_queue.next_entry;
-				continue;
-			}
-		}
-		prev_entry=entry;
-		entry=entry->next;
-	}	
+	PIC_RemoveMatching([=](const PICEntry & entry) {
+		return entry.pic_event==handler;
+	});
+}
+
+const PIC_EventStats & PIC_GetEventStats(void) {
+	return pic_stats;
 }
 
 
@@ -487,22 +541,26 @@ bool PIC_RunQueue(void) {
 	/* Check the queue for an entry */
 	Bits index_nd=PIC_TickIndexND();
 	InEventService = true;
-	while (pic_queue.next_entry && (pic_queue.next_entry->index*CPU_CycleMax<=index_nd)) {
-		PICEntry * entry=pic_queue.next_entry;
-		pic_queue.next_entry=entry->next;
-
-		srv_lag = entry->index;
-		(entry->pic_event)(entry->value); // call the event handler
-
-		/* Put the entry in the free list */
-		entry->next=pic_queue.free_entry;
-		pic_queue.free_entry=entry;
+	while (!pic_queue.heap.empty()) {
+		const Bitu slot=pic_queue.heap[0];
+		const PICEntry & entry=pic_queue.entries[slot];
+		const double index=PIC_EntryIndex(entry);
+		if (index*CPU_CycleMax>index_nd) break;
+
+		const PIC_EventHandler handler=entry.pic_event;
+		const Bitu value=entry.value;
+		/* The slot is released first, the handler may schedule new events */
+		PIC_HeapRemove(slot);
+
+		srv_lag = index;
+		handler(value); // call the event handler
+		pic_stats.dispatched++;
 	}
 	InEventService = false;
 
 	/* Check when to set the new cycle end */
-	if (pic_queue.next_entry) {
-		Bits cycles=(Bits)(pic_queue.next_entry->index*CPU_CycleMax-index_nd);
+	if (!pic_queue.heap.empty()) {
+		Bits cycles=(Bits)(PIC_EntryIndex(pic_queue.entries[pic_queue.heap[0]])*CPU_CycleMax-index_nd);
 		if (GCC_UNLIKELY(!cycles)) cycles=1;
 		if (cycles<CPU_CycleLeft) {
 			CPU_Cycles=cycles;
@@ -550,11 +608,14 @@ void TIMER_AddTick(void) {
 	CPU_CycleLeft=CPU_CycleMax;
 	CPU_Cycles=0;
 	PIC_Ticks++;
-	/* Go through the list of scheduled events and lower their index with 1000 */
-	PICEntry * entry=pic_queue.next_entry;
-	while (entry) {
-		entry->index -= 1.0;
-		entry=entry->next;
+	/* Event times are absolute, only the statistics need updating */
+	pic_stats_second.depth_sum+=pic_queue.heap.size();
+	if (++pic_stats_second.ticks>=1000) {
+		pic_stats.events_per_second=(Bitu)(pic_stats.dispatched-pic_stats_second.dispatched);
+		pic_stats.average_depth=(double)pic_stats_second.depth_sum/pic_stats_second.ticks;
+		pic_stats_second.dispatched=pic_stats.dispatched;
+		pic_stats_second.depth_sum=0;
+		pic_stats_second.ticks=0;
 	}
 	/* Call our list of ticker handlers */
 	TickerBlock * ticker=firstticker;
@@ -609,12 +670,16 @@ public:
 		WriteHandler[2].Install(0xa0,write_command,IO_MB);
 		WriteHandler[3].Install(0xa1,write_data,IO_MB);
 		/* Initialize the pic queue */
-		for (i=0;i<PIC_QUEUESIZE-1;i++) {
-			pic_queue.entries[i].next=&pic_queue.entries[i+1];
-		}
-		pic_queue.entries[PIC_QUEUESIZE-1].next=0;
-		pic_queue.free_entry=&pic_queue.entries[0];
-		pic_queue.next_entry=0;
+		pic_queue.entries.clear();
+		pic_queue.free_slots.clear();
+		pic_queue.heap.clear();
+		pic_queue.entries.reserve(PIC_QUEUESIZE);
+		pic_queue.heap.reserve(PIC_QUEUESIZE);
+		pic_queue.next_order=0;
+		pic_stats=PIC_EventStats();
+		pic_stats_second.dispatched=0;
+		pic_stats_second.depth_sum=0;
+		pic_stats_second.ticks=0;
 	}
 
 	~PIC_8259A(){
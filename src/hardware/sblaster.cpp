@@ -111,6 +111,8 @@ struct SB_INFO {
 		Bitu bits;
 		DmaChannel * chan;
 		Bitu remain_size;
+		PIC_EventId event;		//Pending short transfer
+		bool drained;			//Single cycle transfer ended, no new command yet
 	} dma;
 	bool speaker;
 	bool midi;
@@ -266,6 +268,11 @@ static void PlayDMATransfer(Bitu size);
 typedef void (*process_dma_f)(Bitu);
 static process_dma_f ProcessDMATransfer;
 
+static void CancelDMATransfer() {
+	PIC_RemoveEvent(sb.dma.event);
+	sb.dma.event=0;
+}
+
 static void DSP_SetSpeaker(bool requested_state) {
 	// Speaker-output is already in the requested state
 	if (sb.speaker == requested_state)
@@ -467,10 +474,102 @@ INLINE Bit8u decode_ADPCM_3_sample(Bit8u sample,Bit8u & reference,Bits& scale) {
 	return reference;
 }
 
+/* Decode a whole block of adpcm bytes in one go, the decoder state stays
+ * in locals instead of going through sb.adpcm for every code */
+static Bitu decode_ADPCM_2_block(const Bit8u * data,Bitu len,Bit8u * out) {
+	Bit8u reference = sb.adpcm.reference;
+	Bits scale = sb.adpcm.stepsize;
+	for (Bitu i = 0; i < len; i++) {
+		const Bit8u code = data[i];
+		out[0] = decode_ADPCM_2_sample((code >> 6) & 0x3,reference,scale);
+		out[1] = decode_ADPCM_2_sample((code >> 4) & 0x3,reference,scale);
+		out[2] = decode_ADPCM_2_sample((code >> 2) & 0x3,reference,scale);
+		out[3] = decode_ADPCM_2_sample((code >> 0) & 0x3,reference,scale);
+		out += 4;
+	}
+	sb.adpcm.reference = reference;
+	sb.adpcm.stepsize = scale;
+	return len * 4;
+}
+
+static Bitu decode_ADPCM_3_block(const Bit8u * data,Bitu len,Bit8u * out) {
+	Bit8u reference = sb.adpcm.reference;
+	Bits scale = sb.adpcm.stepsize;
+	for (Bitu i = 0; i < len; i++) {
+		const Bit8u code = data[i];
+		out[0] = decode_ADPCM_3_sample((code >> 5) & 0x7,reference,scale);
+		out[1] = decode_ADPCM_3_sample((code >> 2) & 0x7,reference,scale);
+		out[2] = decode_ADPCM_3_sample((code & 0x3) << 1,reference,scale);
+		out += 3;
+	}
+	sb.adpcm.reference = reference;
+	sb.adpcm.stepsize = scale;
+	return len * 3;
+}
+
+static Bitu decode_ADPCM_4_block(const Bit8u * data,Bitu len,Bit8u * out) {
+	Bit8u reference = sb.adpcm.reference;
+	Bits scale = sb.adpcm.stepsize;
+	for (Bitu i = 0; i < len; i++) {
+		const Bit8u code = data[i];
+		out[0] = decode_ADPCM_4_sample(code >> 4,reference,scale);
+		out[1] = decode_ADPCM_4_sample(code & 0xf,reference,scale);
+		out += 2;
+	}
+	sb.adpcm.reference = reference;
+	sb.adpcm.stepsize = scale;
+	return len * 2;
+}
+
+static SB_DMA_Stats dma_stats = {0, 0, 0, 0};
+
+/* Plain PCM goes from guest memory to the mixer without the bounce buffer,
+ * as far as the dma channel has it in one piece. Returns what was used. */
+static Bitu PlayDirectDMA(Bitu size) {
+	//A half frame left from the last transfer has to go first
+	if (sb.dma.remain_size) return 0;
+	const bool aliased = sb.dma.mode == DSP_DMA_16_ALIASED;
+	const Bitu granule = (sb.dma.stereo ? 2 : 1) << (aliased ? 1 : 0);
+	Bit8u * data = nullptr;
+	const Bitu read = sb.dma.chan->ReadDirect(size, data, granule);
+	if (!read) return 0;
+	dma_stats.direct += read << sb.dma.chan->DMA16;
+	if (sb.dma.mode == DSP_DMA_8) {
+		if (sb.dma.stereo) {
+			if (!sb.dma.sign) sb.chan->AddSamples_s8(read >> 1, data);
+			else sb.chan->AddSamples_s8s(read >> 1, (Bit8s *)data);
+		} else {
+			if (!sb.dma.sign) sb.chan->AddSamples_m8(read, data);
+			else sb.chan->AddSamples_m8s(read, (Bit8s *)data);
+		}
+		return read;
+	}
+	const Bitu samples = aliased ? read >> 1 : read;
+	if (sb.dma.stereo) {
+#if defined(WORDS_BIGENDIAN)
+		if (sb.dma.sign) sb.chan->AddSamples_s16_nonnative(samples >> 1, (Bit16s *)data);
+		else sb.chan->AddSamples_s16u_nonnative(samples >> 1, (Bit16u *)data);
+#else
+		if (sb.dma.sign) sb.chan->AddSamples_s16(samples >> 1, (Bit16s *)data);
+		else sb.chan->AddSamples_s16u(samples >> 1, (Bit16u *)data);
+#endif
+	} else {
+#if defined(WORDS_BIGENDIAN)
+		if (sb.dma.sign) sb.chan->AddSamples_m16_nonnative(samples, (Bit16s *)data);
+		else sb.chan->AddSamples_m16u_nonnative(samples, (Bit16u *)data);
+#else
+		if (sb.dma.sign) sb.chan->AddSamples_m16(samples, (Bit16s *)data);
+		else sb.chan->AddSamples_m16u(samples, (Bit16u *)data);
+#endif
+	}
+	return read;
+}
+
 static void PlayDMATransfer(Bitu size)
 {
-	Bitu read=0;Bitu done=0;Bitu i=0;
+	Bitu read=0;Bitu done=0;Bitu i=0;Bitu direct=0;
 	last_dma_callback = PIC_FullIndex();
+	dma_stats.calls++;
 
 	//Determine how much you should read
 	if(sb.dma.autoinit) {
@@ -491,12 +590,7 @@ static void PlayDMATransfer(Bitu size)
 			sb.adpcm.stepsize=MIN_ADAPTIVE_STEP_SIZE;
 			i++;
 		}
-		for (;i<read;i++) {
-			MixTemp[done++]=decode_ADPCM_2_sample((sb.dma.buf.b8[i] >> 6) & 0x3,sb.adpcm.reference,sb.adpcm.stepsize);
-			MixTemp[done++]=decode_ADPCM_2_sample((sb.dma.buf.b8[i] >> 4) & 0x3,sb.adpcm.reference,sb.adpcm.stepsize);
-			MixTemp[done++]=decode_ADPCM_2_sample((sb.dma.buf.b8[i] >> 2) & 0x3,sb.adpcm.reference,sb.adpcm.stepsize);
-			MixTemp[done++]=decode_ADPCM_2_sample((sb.dma.buf.b8[i] >> 0) & 0x3,sb.adpcm.reference,sb.adpcm.stepsize);
-		}
+		done=decode_ADPCM_2_block(&sb.dma.buf.b8[i],read-i,MixTemp);
 		sb.chan->AddSamples_m8(done,MixTemp);
 		break;
 	case DSP_DMA_3:
@@ -507,11 +601,7 @@ static void PlayDMATransfer(Bitu size)
 			sb.adpcm.stepsize=MIN_ADAPTIVE_STEP_SIZE;
 			i++;
 		}
-		for (;i<read;i++) {
-			MixTemp[done++]=decode_ADPCM_3_sample((sb.dma.buf.b8[i] >> 5) & 0x7,sb.adpcm.reference,sb.adpcm.stepsize);
-			MixTemp[done++]=decode_ADPCM_3_sample((sb.dma.buf.b8[i] >> 2) & 0x7,sb.adpcm.reference,sb.adpcm.stepsize);
-			MixTemp[done++]=decode_ADPCM_3_sample((sb.dma.buf.b8[i] & 0x3) << 1,sb.adpcm.reference,sb.adpcm.stepsize);
-		}
+		done=decode_ADPCM_3_block(&sb.dma.buf.b8[i],read-i,MixTemp);
 		sb.chan->AddSamples_m8(done,MixTemp);
 		break;
 	case DSP_DMA_4:
@@ -522,13 +612,12 @@ static void PlayDMATransfer(Bitu size)
 			sb.adpcm.stepsize=MIN_ADAPTIVE_STEP_SIZE;
 			i++;
 		}
-		for (;i<read;i++) {
-			MixTemp[done++]=decode_ADPCM_4_sample(sb.dma.buf.b8[i] >> 4,sb.adpcm.reference,sb.adpcm.stepsize);
-			MixTemp[done++]=decode_ADPCM_4_sample(sb.dma.buf.b8[i]& 0xf,sb.adpcm.reference,sb.adpcm.stepsize);
-		}
+		done=decode_ADPCM_4_block(&sb.dma.buf.b8[i],read-i,MixTemp);
 		sb.chan->AddSamples_m8(done,MixTemp);
 		break;
 	case DSP_DMA_8:
+		direct=PlayDirectDMA(size);
+		size-=direct;
 		if (sb.dma.stereo) {
 			read=sb.dma.chan->Read(size,&sb.dma.buf.b8[sb.dma.remain_size]);
 			Bitu total=read+sb.dma.remain_size;
@@ -546,6 +635,8 @@ static void PlayDMATransfer(Bitu size)
 		break;
 	case DSP_DMA_16:
 	case DSP_DMA_16_ALIASED:
+		direct=PlayDirectDMA(size);
+		size-=direct;
 		if (sb.dma.stereo) {
 			/* In DSP_DMA_16_ALIASED mode temporarily divide by 2 to get number of 16-bit
 			   samples, because 8-bit DMA Read returns byte size, while in DSP_DMA_16 mode
@@ -584,9 +675,11 @@ static void PlayDMATransfer(Bitu size)
 		return;
 	}
 	//Check how many bytes were actually read
+	read+=direct;
+	dma_stats.bytes+=read << sb.dma.chan->DMA16;
 	sb.dma.left-=read;
 	if (!sb.dma.left) {
-		PIC_RemoveEvents(ProcessDMATransfer);
+		CancelDMATransfer();
 		if (sb.dma.mode >= DSP_DMA_16) 
 			SB_RaiseIRQ(SB_IRQ_16);
 		else 
@@ -596,6 +689,7 @@ static void PlayDMATransfer(Bitu size)
 			//Not new single cycle transfer waiting?
 			if (!sb.dma.singlesize) {
 				LOG(LOG_SB, LOG_NORMAL)("Single cycle transfer ended");
+				sb.dma.drained = true;
 				sb.mode = MODE_NONE;
 				sb.dma.mode = DSP_DMA_NONE;
 			}
@@ -677,7 +771,8 @@ static void FlushRemainingDMATransfer()
 		float delay=(sb.dma.left*1000.0f)/sb.dma.rate;
 		LOG(LOG_SB,LOG_NORMAL)("%s: Short transfer scheduling IRQ in %.3f milliseconds",
 		                       CardType(), delay);
-		PIC_AddEvent(ProcessDMATransfer, delay, sb.dma.left);
+		CancelDMATransfer();
+		sb.dma.event=PIC_AddEvent(ProcessDMATransfer, delay, sb.dma.left);
 	}
 }
 
@@ -728,6 +823,7 @@ static void DSP_DoDMATransfer(const DMA_MODES mode, Bitu freq, bool autoinit, bo
 	}
 	sb.dma.autoinit = autoinit;
 	sb.dma.mode = mode;
+	sb.dma.drained = false;
 	sb.dma.stereo = stereo;
 	//Double the reading speed for stereo mode
 	if (sb.dma.stereo) 
@@ -736,7 +832,7 @@ static void DSP_DoDMATransfer(const DMA_MODES mode, Bitu freq, bool autoinit, bo
 	sb.dma.min=(sb.dma.rate*3)/1000;
 	sb.chan->SetFreq(freq);
 
-	PIC_RemoveEvents(ProcessDMATransfer);
+	CancelDMATransfer();
 	//Set to be masked, the dma call can change this again.
 	sb.mode = MODE_DMA_MASKED;
 	sb.dma.chan->Register_Callback(DSP_DMA_CallBack);
@@ -812,6 +908,7 @@ static void DSP_Reset(void) {
 	PIC_DeActivateIRQ(sb.hw.irq);
 
 	DSP_ChangeMode(MODE_NONE);
+	sb.dma.drained = false;
 	DSP_FlushData();
 	sb.dsp.cmd=DSP_NO_COMMAND;
 	sb.dsp.cmd_len=0;
@@ -839,7 +936,7 @@ static void DSP_Reset(void) {
 	sb.irq.pending_16bit=false;
 	sb.chan->SetFreq(22050);
 	InitializeSpeakerState();
-	PIC_RemoveEvents(ProcessDMATransfer);
+	CancelDMATransfer();
 }
 
 static void DSP_DoReset(Bit8u val) {
@@ -1036,7 +1133,7 @@ static void DSP_DoCommand(void) {
 			// possibly different code here that does not switch to MODE_DMA_PAUSE
 		}
 		sb.mode=MODE_DMA_PAUSE;
-		PIC_RemoveEvents(ProcessDMATransfer);
+		CancelDMATransfer();
 		break;
 	case 0xd1:	/* Enable Speaker */
 		DSP_SetSpeaker(true);
@@ -1609,11 +1706,22 @@ bool SB_Get_Address(Bitu& sbaddr, Bitu& sbirq, Bitu& sbdma) {
 	}
 }
 
+bool SB_Get_DMA_Stats(SB_DMA_Stats& stats) {
+	if (sb.type == SBT_NONE) return false;
+	stats = dma_stats;
+	return true;
+}
+
 static void SBLASTER_CallBack(Bitu len) {
 	switch (sb.mode) {
 	case MODE_NONE:
 	case MODE_DMA_PAUSE:
 	case MODE_DMA_MASKED:
+		//Silence because the game didn't start the next transfer in time
+		if (sb.dma.drained && sb.mode != MODE_DMA_PAUSE) {
+			dma_stats.underruns++;
+			sb.dma.drained = false;
+		}
 		sb.chan->AddSilence();
 		break;
 	case MODE_DAC:
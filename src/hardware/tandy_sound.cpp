@@ -40,7 +40,6 @@
 
 static struct {
 	MixerChannel * chan;
-	bool enabled;
 	Bitu last_write;
 	struct {
 		MixerChannel * chan;
@@ -71,10 +70,7 @@ static sn76496_base_device* activeDevice = &device_ncr8496;
 
 static void SN76496Write(Bitu /*port*/,Bitu data,Bitu /*iolen*/) {
 	tandy.last_write=PIC_Ticks;
-	if (!tandy.enabled) {
-		tandy.chan->Enable(true);
-		tandy.enabled=true;
-	}
+	if (!tandy.chan->is_enabled) tandy.chan->Enable(true);
 	device.write(data);
 
 	//	LOG_MSG("3voice write %#" PRIxPTR " at time
@@ -84,7 +80,6 @@ static void SN76496Write(Bitu /*port*/,Bitu data,Bitu /*iolen*/) {
 static void SN76496Update(Bitu length) {
 	//Disable the channel if it's been quiet for a while
 	if ((tandy.last_write+5000)<PIC_Ticks) {
-		tandy.enabled=false;
 		tandy.chan->Enable(false);
 		return;
 	}
@@ -305,6 +300,7 @@ public:
 
 		Bit32u sample_rate = section->Get_int("tandyrate");
 		tandy.chan=MixerChan.Install(&SN76496Update,sample_rate,"TANDY");
+		tandy.chan->SetSleep(1000);
 
 		WriteHandler[0].Install(0xc0,SN76496Write,IO_MB,2);
 
@@ -333,8 +329,6 @@ public:
 		tandy.dac.amplitude=0;
 		tandy.dac.dma.last_sample=0;
 
-
-		tandy.enabled=false;
 		real_writeb(0x40,0xd4,0xff);	/* BIOS Tandy DAC initialization value */
 
 		((device_t&)device).device_start();
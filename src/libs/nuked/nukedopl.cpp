@@ -327,6 +327,27 @@ static Bit16s OPL3_EnvelopeCalcSin7(Bit16u phase, Bit16u envelope)
     return OPL3_EnvelopeCalcExp(out + (envelope << 3)) ^ neg;
 }
 
+//
+// Below an attenuation of 0x180 every waveform has decayed to zero and only
+// the sign of the negative halves is left, which doesn't need the tables
+//
+
+static Bit16s OPL3_EnvelopeCalcSilent(Bit8u wf, Bit16u phase)
+{
+    phase &= 0x3ff;
+    switch (wf)
+    {
+    case 0:
+    case 6:
+    case 7:
+        return (phase & 0x200) ? -1 : 0;
+    case 4:
+        return ((phase & 0x300) == 0x100) ? -1 : 0;
+    default:
+        return 0;
+    }
+}
+
 static const envelope_sinfunc envelope_sin[8] = {
     OPL3_EnvelopeCalcSin0,
     OPL3_EnvelopeCalcSin1,
@@ -372,6 +393,13 @@ static void OPL3_EnvelopeCalc(opl3_slot *slot)
     Bit8u reset = 0;
     slot->eg_out = slot->eg_rout + (slot->reg_tl << 2)
                  + (slot->eg_ksl >> kslshift[slot->reg_ksl]) + *slot->trem;
+    // Released slot which has fully decayed stays that way
+    if (!slot->key && slot->eg_gen == envelope_gen_num_release
+        && slot->eg_rout == 0x1ff)
+    {
+        slot->pg_reset = 0;
+        return;
+    }
     if (slot->key && slot->eg_gen == envelope_gen_num_release)
     {
         reset = 1;
@@ -662,6 +690,11 @@ static void OPL3_SlotWriteE0(opl3_slot *slot, Bit8u data)
 
 static void OPL3_SlotGenerate(opl3_slot *slot)
 {
+    if (slot->eg_out >= 0x180)
+    {
+        slot->out = OPL3_EnvelopeCalcSilent(slot->reg_wf, slot->pg_phase_out + *slot->mod);
+        return;
+    }
     slot->out = envelope_sin[slot->reg_wf](slot->pg_phase_out + *slot->mod, slot->eg_out);
 }
 